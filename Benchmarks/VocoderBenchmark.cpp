@@ -0,0 +1,150 @@
+// VocoderBenchmark.cpp - CPU and memory of every vocoder engine across block
+// sizes and sample rates
+
+#include "../Source/VocoderEngine.h"
+#include "../Source/NoiseEngine.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Heap bytes handed out since the start. Every allocation in the process,
+// over-aligned ones included, goes through these, so the difference across
+// prepare is what it allocated.
+static std::atomic<size_t> allocatedBytes { 0 };
+
+void* operator new(std::size_t size)
+{
+    allocatedBytes += size;
+    
+    if (auto* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocatedBytes += size;
+    const auto align = juce::jmax((std::size_t) alignment, sizeof(void*));
+    
+   #if JUCE_WINDOWS
+    if (auto* p = _aligned_malloc(size == 0 ? 1 : size, align))
+        return p;
+   #else
+    void* p = nullptr;
+    
+    if (posix_memalign(&p, align, size == 0 ? 1 : size) == 0)
+        return p;
+   #endif
+    
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept                { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept   { std::free(p); }
+
+#if JUCE_WINDOWS
+void operator delete(void* p, std::align_val_t) noexcept                { _aligned_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept   { _aligned_free(p); }
+#else
+void operator delete(void* p, std::align_val_t) noexcept                { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept   { std::free(p); }
+#endif
+
+namespace
+{
+    constexpr int numChannels = 2;
+    constexpr double secondsToTime = 5.0;
+    
+    struct Result
+    {
+        double nsPerSample = 0.0;       // Per channel
+        double realtimePercent = 0.0;   // Of one core
+        size_t preparedBytes = 0;
+    };
+    
+    Result run(VocoderEngine::Type type, double sampleRate, int blockSize)
+    {
+        Result result;
+        
+        // White noise input at about -10dB, like a busy mix
+        NoiseEngine noiseSource, inputSource;
+        noiseSource.setSeed(1);
+        inputSource.setSeed(2);
+        noiseSource.prepare(numChannels);
+        inputSource.prepare(numChannels);
+        
+        // Everything the engine allocates happens in create and prepare. The
+        // filterbank's carrier tables are shared, so this is the cost of the
+        // first instance at this rate; later ones add only their own state.
+        const size_t before = allocatedBytes;
+        auto engine = VocoderEngine::create(type, noiseSource);
+        engine->prepare(sampleRate, numChannels);
+        result.preparedBytes = allocatedBytes - before;
+        
+        VocoderEngine::Parameters parameters;
+        parameters.gain = 0.5f;
+        parameters.release = 0.3f;
+        parameters.brightness = 0.5f;
+        parameters.numBands = 16;
+        
+        juce::AudioBuffer<float> input(numChannels, blockSize), output(numChannels, blockSize);
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            inputSource.fill(channel, input.getWritePointer(channel), blockSize);
+            input.applyGain(channel, 0, blockSize, 0.3f);
+        }
+        
+        // A second of warm-up so caches and the branch predictor settle
+        const int warmUpBlocks = (int) (sampleRate / blockSize);
+        const int timedBlocks = (int) (sampleRate * secondsToTime / blockSize);
+        
+        for (int block = 0; block < warmUpBlocks; ++block)
+            engine->process(input, output, parameters);
+        
+        const auto start = std::chrono::steady_clock::now();
+        
+        for (int block = 0; block < timedBlocks; ++block)
+            engine->process(input, output, parameters);
+        
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double samples = (double) timedBlocks * blockSize;
+        
+        result.nsPerSample = elapsed * 1.0e9 / (samples * numChannels);
+        result.realtimePercent = elapsed * 100.0 / (samples / sampleRate);
+        return result;
+    }
+}
+
+int main()
+{
+    juce::ScopedNoDenormals noDenormals;
+    
+    const double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+    const int blockSizes[] = { 64, 256, 512, 1024 };
+    const auto names = VocoderEngine::getTypeNames();
+    
+    std::printf("%d channels, %.0f s timed per run, 16 filterbank bands\n\n", numChannels, secondsToTime);
+    std::printf("%-12s %8s %6s %14s %10s %12s\n", "engine", "rate", "block", "ns/sample/ch", "% of core", "prepare KB");
+    
+    for (int index = 0; index < names.size(); ++index)
+    {
+        const auto type = (VocoderEngine::Type) index;
+        
+        for (const double sampleRate : sampleRates)
+        {
+            for (const int blockSize : blockSizes)
+            {
+                const auto result = run(type, sampleRate, blockSize);
+                std::printf("%-12s %8.0f %6d %14.1f %10.2f %12.1f\n",
+                            names[index].toRawUTF8(), sampleRate, blockSize,
+                            result.nsPerSample, result.realtimePercent, result.preparedBytes / 1024.0);
+            }
+        }
+    }
+    
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include "CombBank.h"
+
+CombBank::CombBank()
+{
+    for (auto& store : filterStore)
+        store = Vec::expand(0.0f);
+    
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        buffers[lane] = nullptr;
+        bufSizes[lane] = 0;
+        bufIdx[lane] = 0;
+    }
+    
+    setFeedback(0.0f);
+    setDamp(0.0f);
+    skipRamp();
+}
+
+void CombBank::setBuffer(int lane, float* buf, int size)
+{
+    jassert (lane >= 0 && lane < numLanes);
+    
+    buffers[lane] = buf;
+    bufSizes[lane] = size;
+    bufIdx[lane] = 0;
+}
+
+void CombBank::mute()
+{
+    for (int lane = 0; lane < numLanes; ++lane)
+        if (buffers[lane] != nullptr)
+            juce::FloatVectorOperations::clear(buffers[lane], bufSizes[lane]);
+    
+    for (auto& store : filterStore)
+        store = Vec::expand(0.0f);
+}
+
+void CombBank::setFeedback(float value)
+{
+    if (value == feedbackTarget)
+        return;
+    
+    feedbackTarget = value;
+    startRamp();
+}
+
+void CombBank::setDamp(float value)
+{
+    if (value == dampTarget)
+        return;
+    
+    dampTarget = value;
+    startRamp();
+}
+
+void CombBank::setRampLength(int numSamples)
+{
+    rampLength = juce::jmax(1, numSamples);
+}
+
+void CombBank::skipRamp()
+{
+    feedback = Vec::expand(feedbackTarget);
+    damp1 = Vec::expand(dampTarget);
+    damp2 = Vec::expand(1.0f - dampTarget);
+    feedbackStep = Vec::expand(0.0f);
+    dampStep = Vec::expand(0.0f);
+    rampRemaining = 0;
+}
+
+void CombBank::startRamp()
+{
+    // Restart from wherever the current ramp has got to, so retargeting
+    // mid-ramp stays continuous
+    const float scale = 1.0f / (float) rampLength;
+    feedbackStep = Vec::expand((feedbackTarget - feedback.get(0)) * scale);
+    dampStep = Vec::expand((dampTarget - damp1.get(0)) * scale);
+    rampRemaining = rampLength;
+}
+
+void CombBank::processBlock(const float* input, float* outL, float* outR, int numSamples)
+{
+    for (int v = 0; v < numVecs; ++v)
+    {
+        const int firstLane = v * lanesPerVec;
+        const bool isLeft = v < numVecs / 2;
+        const bool isFirstOfChannel = (v == 0 || v == numVecs / 2);
+        float* out = isLeft ? outL : outR;
+        
+        auto store = filterStore[v];
+        
+        // Every register follows the same coefficient ramp over the block
+        auto fb = feedback, d1 = damp1, d2 = damp2;
+        int rampLeft = rampRemaining;
+        
+        alignas (16) float taps[lanesPerVec];
+        alignas (16) float writes[lanesPerVec];
+        
+        int done = 0;
+        
+        while (done < numSamples)
+        {
+            // Run as far as possible before any lane in this register wraps,
+            // so the inner loop has no index checks
+            int segment = numSamples - done;
+            for (int lane = 0; lane < lanesPerVec; ++lane)
+                segment = juce::jmin(segment, bufSizes[firstLane + lane] - bufIdx[firstLane + lane]);
+            
+            float* lines[lanesPerVec];
+            for (int lane = 0; lane < lanesPerVec; ++lane)
+                lines[lane] = buffers[firstLane + lane] + bufIdx[firstLane + lane];
+            
+            for (int i = 0; i < segment; ++i)
+            {
+                if (rampLeft > 0)
+                {
+                    if (--rampLeft == 0)
+                    {
+                        fb = Vec::expand(feedbackTarget);
+                        d1 = Vec::expand(dampTarget);
+                        d2 = Vec::expand(1.0f - dampTarget);
+                    }
+                    else
+                    {
+                        fb += feedbackStep;
+                        d1 += dampStep;
+                        d2 -= dampStep;
+                    }
+                }
+                
+                for (int lane = 0; lane < lanesPerVec; ++lane)
+                    taps[lane] = lines[lane][i];
+                
+                const auto tap = Vec::fromRawArray(taps);
+                store = tap * d2 + store * d1;
+                (Vec::expand(input[done + i]) + store * fb).copyToRawArray(writes);
+                
+                for (int lane = 0; lane < lanesPerVec; ++lane)
+                    lines[lane][i] = writes[lane];
+                
+                if (isFirstOfChannel)
+                    out[done + i] = tap.sum();
+                else
+                    out[done + i] += tap.sum();
+            }
+            
+            for (int lane = 0; lane < lanesPerVec; ++lane)
+            {
+                auto& idx = bufIdx[firstLane + lane];
+                idx += segment;
+                if (idx >= bufSizes[firstLane + lane])
+                    idx = 0;
+            }
+            
+            done += segment;
+        }
+        
+        filterStore[v] = store;
+        
+        // All registers end up in the same place - keep the last one's
+        if (v == numVecs - 1)
+        {
+            feedback = fb;
+            damp1 = d1;
+            damp2 = d2;
+            rampRemaining = rampLeft;
+            
+            if (rampRemaining == 0)
+                skipRamp();
+        }
+    }
+}
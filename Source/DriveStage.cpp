@@ -0,0 +1,183 @@
+#include "DriveStage.h"
+
+void DriveStage::prepare(double sampleRate, int newNumChannels, int maximumBlockSize)
+{
+    juce::ignoreUnused(sampleRate);
+    numChannels = newNumChannels;
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+
+    for (size_t i = 0; i < oversamplers.size(); ++i)
+    {
+        oversamplers[i] = std::make_unique<juce::dsp::Oversampling<float>>(
+            (size_t) juce::jmax(1, numChannels), i + 1,
+            juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+        oversamplers[i]->initProcessing((size_t) maxBlockSize);
+    }
+
+    delayLine.setSize(juce::jmax(1, numChannels), juce::jmax(1, getLatencySamples(maxOversamplingOrder)));
+    fadeBuffer.setSize(juce::jmax(1, numChannels), maxBlockSize);
+
+    reset();
+}
+
+void DriveStage::reset()
+{
+    for (auto& oversampler : oversamplers)
+        if (oversampler != nullptr)
+            oversampler->reset();
+
+    delayLine.clear();
+    delayPosition = 0;
+    driveWasOn = false;
+}
+
+void DriveStage::setOversamplingOrder(int newOrder)
+{
+    newOrder = juce::jlimit(0, maxOversamplingOrder, newOrder);
+
+    if (newOrder == order)
+        return;
+
+    order = newOrder;
+
+    if (order > 0 && oversamplers[(size_t) order - 1] != nullptr)
+        oversamplers[(size_t) order - 1]->reset();
+
+    // The delay length changes with the order
+    delayLine.clear();
+    delayPosition = 0;
+}
+
+int DriveStage::getLatencySamples() const
+{
+    return getLatencySamples(order);
+}
+
+int DriveStage::getLatencySamples(int forOrder) const
+{
+    if (forOrder <= 0 || oversamplers[(size_t) forOrder - 1] == nullptr)
+        return 0;
+
+    return juce::roundToInt(oversamplers[(size_t) forOrder - 1]->getLatencyInSamples());
+}
+
+void DriveStage::process(juce::AudioBuffer<float>& buffer, float drive)
+{
+    const int channelsToProcess = juce::jmin(numChannels, buffer.getNumChannels());
+    const int numSamples = buffer.getNumSamples();
+
+    if (channelsToProcess == 0 || numSamples == 0)
+        return;
+
+    juce::dsp::AudioBlock<float> block = juce::dsp::AudioBlock<float>(buffer).getSubsetChannelBlock(0, (size_t) channelsToProcess);
+
+    const bool driveOn = drive > 0.01f;
+
+    if (order == 0 || oversamplers[(size_t) order - 1] == nullptr)
+    {
+        saturateBlock(block, drive);
+        driveWasOn = driveOn;
+        return;
+    }
+
+    // The oversampler is sized for maxBlockSize, so chunk bigger host blocks
+    auto& oversampler = *oversamplers[(size_t) order - 1];
+
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+    {
+        const int chunkLength = juce::jmin(maxBlockSize, numSamples - start);
+        auto chunk = block.getSubBlock((size_t) start, (size_t) chunkLength);
+
+        // Drive off: only the matching delay
+        if (! driveOn && ! driveWasOn)
+        {
+            delay(chunk, true);
+            continue;
+        }
+
+        // Keep the delay line fed from a copy, or render the delayed path
+        // into it to crossfade against
+        juce::dsp::AudioBlock<float> fadeBlock(fadeBuffer);
+        auto other = fadeBlock.getSubsetChannelBlock(0, (size_t) channelsToProcess).getSubBlock(0, (size_t) chunkLength);
+        other.copyFrom(chunk);
+        delay(other, driveOn != driveWasOn);
+
+        // The oversampler was skipped while the drive was off, so its state is stale
+        if (driveOn && ! driveWasOn)
+            oversampler.reset();
+
+        auto oversampled = oversampler.processSamplesUp(chunk);
+        saturateBlock(oversampled, drive);
+        oversampler.processSamplesDown(chunk);
+
+        if (driveOn != driveWasOn)
+        {
+            const float from = driveOn ? 0.0f : 1.0f;
+
+            for (int channel = 0; channel < channelsToProcess; ++channel)
+            {
+                buffer.applyGainRamp(channel, start, chunkLength, from, 1.0f - from);
+                buffer.addFromWithRamp(channel, start, fadeBuffer.getReadPointer(channel), chunkLength, 1.0f - from, from);
+            }
+
+            driveWasOn = driveOn;
+        }
+    }
+}
+
+void DriveStage::delay(juce::dsp::AudioBlock<float>& block, bool writeOutput)
+{
+    const int length = getLatencySamples();
+
+    if (length == 0)
+        return;
+
+    const int capacity = delayLine.getNumSamples();
+    const int numSamples = (int) block.getNumSamples();
+    int position = delayPosition;
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        float* line = delayLine.getWritePointer((int) channel);
+        float* data = block.getChannelPointer(channel);
+        position = delayPosition;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float input = data[i];
+
+            if (writeOutput)
+                data[i] = line[(position + capacity - length) % capacity];
+
+            line[position] = input;
+            position = position + 1 == capacity ? 0 : position + 1;
+        }
+    }
+
+    delayPosition = position;
+}
+
+void DriveStage::saturateBlock(juce::dsp::AudioBlock<float>& block, float drive) const
+{
+    if (drive <= 0.01f)
+        return;
+
+    const float driveGain = 1.0f + drive * 4.0f;            // Up to 5x gain
+    const float outputGain = 1.0f / (1.0f + drive * 0.5f);  // Compensate gain
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        saturate(block.getChannelPointer(channel), (int) block.getNumSamples(), driveGain, outputGain);
+}
+
+void DriveStage::saturate(float* data, int numSamples, float gain, float outputGain)
+{
+    // The rational tanh crosses 1 at about 4.97 and overshoots beyond it, so
+    // clamp there first; the clamp is its own pass so the main loop has no
+    // branches and vectorises
+    constexpr float limit = 4.97f;
+    juce::FloatVectorOperations::multiply(data, gain, numSamples);
+    juce::FloatVectorOperations::clip(data, data, -limit, limit, numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+        data[i] = juce::dsp::FastMathApproximations::tanh(data[i]) * outputGain;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <memory>
+
+// Pre-filter drive: a tanh soft clip with gain compensation, run at 1x, 2x
+// or 4x the sample rate. Oversampling uses JUCE's polyphase IIR half-band
+// filters with integer latency, and only wraps the nonlinearity. The tanh is
+// a clamped rational approximation written as a plain loop so the compiler
+// vectorises it.
+//
+// While oversampling with the drive off, process() skips the up/down filters
+// and only runs a plain delay of the same length, so the reported latency
+// stays true whatever the drive setting but nothing is coloured. Turning the
+// drive on or off crossfades between the two paths over one chunk.
+class DriveStage
+{
+public:
+    static constexpr int maxOversamplingOrder = 2;  // 4x
+
+    DriveStage() = default;
+
+    // Allocates an oversampler for every order; not real-time safe
+    void prepare(double sampleRate, int numChannels, int maximumBlockSize);
+    void reset();
+
+    // 0 = 1x, 1 = 2x, 2 = 4x. Doesn't allocate; resets the newly selected
+    // oversampler.
+    void setOversamplingOrder(int newOrder);
+    int getOversamplingOrder() const { return order; }
+
+    // Latency of the selected order at the base rate
+    int getLatencySamples() const;
+    int getLatencySamples(int forOrder) const;
+
+    // drive is 0-1 (up to 5x gain into the clipper). Channels beyond those
+    // prepared are left alone.
+    void process(juce::AudioBuffer<float>& buffer, float drive);
+
+    // In-place clamped rational tanh of data x gain, times outputGain
+    static void saturate(float* data, int numSamples, float gain, float outputGain);
+
+private:
+    void saturateBlock(juce::dsp::AudioBlock<float>& block, float drive) const;
+    
+    // Runs block through the latency-matched delay; with writeOutput false it
+    // only feeds the line, so it's ready whenever the drive turns off
+    void delay(juce::dsp::AudioBlock<float>& block, bool writeOutput);
+
+    // Index order - 1; 1x needs none
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, maxOversamplingOrder> oversamplers;
+    int order = 0;
+    int numChannels = 0;
+    int maxBlockSize = 0;
+    
+    // Holds the last input samples for the longest latency of any order
+    juce::AudioBuffer<float> delayLine;
+    int delayPosition = 0;
+    
+    juce::AudioBuffer<float> fadeBuffer;    // The other path while crossfading
+    bool driveWasOn = false;
+};
@@ -0,0 +1,195 @@
+#include "FilterCascade.h"
+#include <cmath>
+
+void FilterCascade::prepare(double newSampleRate, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    numChannels = newNumChannels;
+    groups.resize((size_t) ((numChannels + lanesPerVec - 1) / lanesPerVec));
+    
+    const auto numPoints = (size_t) std::ceil(std::log2(maxFrequency / minFrequency) * pointsPerOctave) + 1;
+    prewarpTable.resize(numPoints);
+    
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        const auto frequency = juce::jmin(minFrequency * std::exp2((float) i / pointsPerOctave), (float) (sampleRate * 0.49));
+        prewarpTable[i] = (float) std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    }
+    
+    // Safe defaults until the first set call: a wide open band
+    setHighPass(20.0f, 0.5f);
+    setLowPass(20000.0f, 0.5f);
+    finishSweeps();
+    
+    reset();
+}
+
+void FilterCascade::reset()
+{
+    const auto zero = Vec::expand(0.0f);
+    
+    for (auto& state : groups)
+    {
+        for (int section = 0; section < numSections; ++section)
+        {
+            for (int stage = 0; stage < maxStages; ++stage)
+                state.s1[section][stage] = state.s2[section][stage] = zero;
+        }
+    }
+}
+
+void FilterCascade::setHighPass(float frequency, float resonance)
+{
+    setSection(highPass, frequency, resonance);
+}
+
+void FilterCascade::setLowPass(float frequency, float resonance)
+{
+    setSection(lowPass, frequency, resonance);
+}
+
+void FilterCascade::setSection(Section section, float frequency, float resonance)
+{
+    // Keep the cutoff clear of Nyquist, where tan() runs away
+    const auto cutoff = juce::jlimit(1.0f, (float) (sampleRate * 0.49), frequency);
+    const auto position = std::log2(cutoff / minFrequency) * pointsPerOctave;
+    
+    target[section].position = juce::jlimit(0.0f, (float) (prewarpTable.size() - 1), position);
+    target[section].resonance = resonance;
+    targetPrewarp[section] = (float) std::tan(juce::MathConstants<double>::pi * cutoff / sampleRate);
+    sweeping[section] = target[section] != current[section];
+    
+    // Nothing to sweep from yet
+    if (prewarpTable.empty())
+    {
+        current[section] = target[section];
+        sweeping[section] = false;
+        setCoefficients(section, targetPrewarp[section], resonance);
+    }
+}
+
+void FilterCascade::setCoefficients(Section section, float g, float resonance)
+{
+    const float stageResonances[2] = { resonance, 0.5f };
+    
+    for (int i = 0; i < 2; ++i)
+    {
+        const auto R2 = 1.0f / stageResonances[i];
+        auto& c = coefficients[section][i];
+        c.g = Vec::expand(g);
+        c.k = Vec::expand(g + R2);
+        c.h = Vec::expand(1.0f / (1.0f + R2 * g + g * g));
+    }
+}
+
+void FilterCascade::updateSweeps(int sample, int numSamples)
+{
+    const int numSteps = (numSamples + controlInterval - 1) / controlInterval;
+    const int step = sample / controlInterval + 1;
+    
+    for (int i = 0; i < numSections; ++i)
+    {
+        if (! sweeping[i])
+            continue;
+        
+        const auto section = (Section) i;
+        
+        if (step >= numSteps)
+        {
+            setCoefficients(section, targetPrewarp[i], target[i].resonance);
+            continue;
+        }
+        
+        const auto proportion = (float) step / (float) numSteps;
+        const auto position = current[i].position + (target[i].position - current[i].position) * proportion;
+        const auto resonance = current[i].resonance + (target[i].resonance - current[i].resonance) * proportion;
+        setCoefficients(section, getPrewarp(position), resonance);
+    }
+}
+
+float FilterCascade::getPrewarp(float position) const
+{
+    // position is kept inside the table by setSection
+    const auto index = juce::jmin((int) position, (int) prewarpTable.size() - 2);
+    const auto fraction = position - (float) index;
+    return prewarpTable[(size_t) index] + (prewarpTable[(size_t) index + 1] - prewarpTable[(size_t) index]) * fraction;
+}
+
+void FilterCascade::process(juce::AudioBuffer<float>& buffer, int numHighPassStages, int numLowPassStages)
+{
+    numHighPassStages = juce::jlimit(0, maxStages, numHighPassStages);
+    numLowPassStages = juce::jlimit(0, maxStages, numLowPassStages);
+    
+    if (numHighPassStages + numLowPassStages == 0)
+    {
+        finishSweeps();
+        return;
+    }
+    
+    const bool anySweeping = sweeping[highPass] || sweeping[lowPass];
+    const int numSamples = buffer.getNumSamples();
+    const int channelsToProcess = juce::jmin(numChannels, buffer.getNumChannels());
+    
+    for (int group = 0; group * lanesPerVec < channelsToProcess; ++group)
+    {
+        // Lanes without a channel run on silence
+        alignas (16) float frame[chunkSize][lanesPerVec] = {};
+        
+        auto& state = groups[(size_t) group];
+        const int firstChannel = group * lanesPerVec;
+        const int lanesUsed = juce::jmin(lanesPerVec, channelsToProcess - firstChannel);
+        
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const int count = juce::jmin(chunkSize, numSamples - start);
+            
+            // Interleave this group's channels, one register per sample
+            for (int lane = 0; lane < lanesUsed; ++lane)
+            {
+                const float* input = buffer.getReadPointer(firstChannel + lane, start);
+                
+                for (int i = 0; i < count; ++i)
+                    frame[i][lane] = input[i];
+            }
+            
+            for (int first = 0; first < count; first += controlInterval)
+            {
+                if (anySweeping)
+                    updateSweeps(start + first, numSamples);
+                
+                const int last = juce::jmin(count, first + controlInterval);
+                
+                for (int i = first; i < last; ++i)
+                {
+                    auto x = Vec::fromRawArray(frame[i]);
+                    x = processStages<highPass>(state, x, numHighPassStages);
+                    x = processStages<lowPass>(state, x, numLowPassStages);
+                    x.copyToRawArray(frame[i]);
+                }
+            }
+            
+            for (int lane = 0; lane < lanesUsed; ++lane)
+            {
+                float* output = buffer.getWritePointer(firstChannel + lane, start);
+                
+                for (int i = 0; i < count; ++i)
+                    output[i] = frame[i][lane];
+            }
+        }
+    }
+    
+    finishSweeps();
+}
+
+void FilterCascade::finishSweeps()
+{
+    for (int i = 0; i < numSections; ++i)
+    {
+        if (! sweeping[i])
+            continue;
+        
+        current[i] = target[i];
+        sweeping[i] = false;
+        setCoefficients((Section) i, targetPrewarp[i], target[i].resonance);
+    }
+}
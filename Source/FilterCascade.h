@@ -0,0 +1,135 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+// The build-up filter: a highpass cascade followed by a lowpass cascade of up
+// to maxStages state variable stages each, all run in one pass per sample.
+// Channels sit in SIMD lanes, lanesPerVec at a time, so a stereo block costs
+// the same as a mono one, and the cost grows only with the stages in use.
+// Every stage uses the same TPT update as juce::dsp::StateVariableTPTFilter,
+// so results match a chain of those filters to float rounding. The first
+// stage of each cascade takes the given resonance and the rest are critically
+// damped (0.5), so only the first one rings. No per-sample denormal handling:
+// run under juce::ScopedNoDenormals.
+//
+// A new cutoff or resonance doesn't jump: process() sweeps each section from
+// its old settings to the new ones across the block, in log frequency,
+// updating the coefficients every controlInterval samples. The prewarp during
+// a sweep comes from a table over 20Hz-20kHz built in prepare, so a sweep
+// costs no tan() calls; the sweep lands on the exact coefficients.
+class FilterCascade
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    
+    static constexpr int lanesPerVec = (int) Vec::SIMDNumElements;
+    static constexpr int maxStages = 8;
+    
+    FilterCascade() = default;
+    
+    // Allocates numChannels channels of state and the prewarp table, resets
+    // the state and opens both sections wide (20Hz highpass, 20kHz lowpass)
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+    
+    // Targets for the next process call to sweep to. Each costs one tan();
+    // stage counts are chosen per call to process.
+    void setHighPass(float frequency, float resonance);
+    void setLowPass(float frequency, float resonance);
+    
+    // Filters buffer in place through numHighPassStages highpass stages and
+    // then numLowPassStages lowpass stages (0 to maxStages each). Channels
+    // beyond those prepared are left alone.
+    void process(juce::AudioBuffer<float>& buffer, int numHighPassStages, int numLowPassStages);
+
+private:
+    // Samples interleaved into registers at a time
+    static constexpr int chunkSize = 32;
+    
+    // Samples between coefficient updates during a sweep
+    static constexpr int controlInterval = 8;
+    static_assert (chunkSize % controlInterval == 0, "Updates must fall on chunk boundaries");
+    
+    // Prewarp table range and resolution
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float pointsPerOctave = 64.0f;
+    
+    enum Section { highPass = 0, lowPass, numSections };
+    
+    // SVF coefficients, the same in every lane:
+    // g = tan(pi fc / fs), k = g + 1/Q, h = 1 / (1 + g/Q + g^2)
+    struct StageCoefficients
+    {
+        Vec g, k, h;
+    };
+    
+    // Integrator states for every stage of both sections
+    struct GroupState
+    {
+        Vec s1[numSections][maxStages], s2[numSections][maxStages];
+    };
+    
+    // A section's cutoff as a prewarp table position, and its resonance
+    struct Settings
+    {
+        float position = 0.0f;
+        float resonance = 0.5f;
+        
+        bool operator== (const Settings& other) const { return position == other.position && resonance == other.resonance; }
+        bool operator!= (const Settings& other) const { return ! operator== (other); }
+    };
+    
+    void setSection(Section section, float frequency, float resonance);
+    void setCoefficients(Section section, float g, float resonance);
+    
+    // Moves every sweeping section to where it should be after the
+    // controlInterval samples that start at sample, of numSamples
+    void updateSweeps(int sample, int numSamples);
+    
+    // Ends every sweep on its target's exact coefficients
+    void finishSweeps();
+    
+    float getPrewarp(float position) const;
+    
+    template <Section section>
+    inline Vec processStages(GroupState& state, Vec x, int numStages) const;
+    
+    // Index 0 is the resonant first stage, 1 every stage after it
+    StageCoefficients coefficients[numSections][2];
+    
+    // Each section sweeps from current to target during a block
+    Settings current[numSections], target[numSections];
+    float targetPrewarp[numSections] = {};   // Exact g for the target
+    bool sweeping[numSections] = {};
+    
+    // tan(pi f / fs) at pointsPerOctave log-spaced frequencies from minFrequency
+    std::vector<float> prewarpTable;
+    
+    std::vector<GroupState> groups;
+    int numChannels = 0;
+    double sampleRate = 44100.0;
+};
+
+template <FilterCascade::Section section>
+inline FilterCascade::Vec FilterCascade::processStages(GroupState& state, Vec x, int numStages) const
+{
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        const auto& c = coefficients[section][stage == 0 ? 0 : 1];
+        auto& s1 = state.s1[section][stage];
+        auto& s2 = state.s2[section][stage];
+        
+        const auto yHP = (x - s1 * c.k - s2) * c.h;
+        const auto yBP = yHP * c.g + s1;
+        s1 = yHP * c.g + yBP;
+        const auto yLP = yBP * c.g + s2;
+        s2 = yBP * c.g + yLP;
+        
+        x = section == highPass ? yHP : yLP;
+    }
+    
+    return x;
+}
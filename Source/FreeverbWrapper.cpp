@@ -13,6 +13,11 @@ FreeverbWrapper::FreeverbWrapper()
 
 void FreeverbWrapper::prepare(double sampleRate, int maximumBlockSize)
 {
+    // Scale the delay lines to the running rate - they are only
+    // reallocated when the rate actually changes
+    if ((int)sampleRate != currentSampleRate)
+        model.setsamplerate(sampleRate);
+    
     currentSampleRate = (int)sampleRate;
     
     // Ensure we have a stereo buffer for processing
@@ -22,6 +27,12 @@ void FreeverbWrapper::prepare(double sampleRate, int maximumBlockSize)
     reset();
 }
 
+size_t FreeverbWrapper::getMemoryFootprint()
+{
+    return sizeof(FreeverbWrapper) - sizeof(revmodel) + model.getmemorysize()
+         + (size_t)(stereoBuffer.getNumChannels() * stereoBuffer.getNumSamples()) * sizeof(float);
+}
+
 void FreeverbWrapper::reset()
 {
     model.mute();
@@ -36,39 +47,60 @@ void FreeverbWrapper::process(juce::AudioBuffer<float>& buffer)
     // Freeverb expects stereo input, so we need to handle mono/stereo cases
     if (numChannels == 1)
     {
-        // Mono input - duplicate to stereo
-        stereoBuffer.setSize(2, numSamples, false, false, true);
-        stereoBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
-        stereoBuffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
+        // Mono input - feed the one channel to both sides, process into the
+        // stereo buffer and fold back. stereoBuffer is sized in prepare, so
+        // chunk rather than resize if a host ever sends a bigger block.
+        const int chunkSize = juce::jmax(1, stereoBuffer.getNumSamples());
         
-        // Process through Freeverb
-        model.processreplace(stereoBuffer.getWritePointer(0),
-                           stereoBuffer.getWritePointer(1),
-                           stereoBuffer.getWritePointer(0),
-                           stereoBuffer.getWritePointer(1),
-                           numSamples, 1);
-        
-        // Mix back to mono
-        buffer.copyFrom(0, 0, stereoBuffer, 0, 0, numSamples);
-        buffer.applyGain(0, 0, numSamples, 0.5f);
-        buffer.addFrom(0, 0, stereoBuffer, 1, 0, numSamples, 0.5f);
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const int chunk = juce::jmin(chunkSize, numSamples - start);
+            const float* input = buffer.getReadPointer(0, start);
+            
+            model.processblockreplace(input, input,
+                                      stereoBuffer.getWritePointer(0),
+                                      stereoBuffer.getWritePointer(1),
+                                      chunk);
+            
+            // Mix back to mono
+            buffer.copyFrom(0, start, stereoBuffer, 0, 0, chunk);
+            buffer.applyGain(0, start, chunk, 0.5f);
+            buffer.addFrom(0, start, stereoBuffer, 1, 0, chunk, 0.5f);
+        }
     }
     else if (numChannels >= 2)
     {
-        // Stereo or multi-channel - process first two channels
-        stereoBuffer.setSize(2, numSamples, false, false, true);
-        stereoBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
-        stereoBuffer.copyFrom(1, 0, buffer, 1, 0, numSamples);
-        
-        // Process through Freeverb
-        model.processreplace(stereoBuffer.getWritePointer(0),
-                           stereoBuffer.getWritePointer(1),
-                           stereoBuffer.getWritePointer(0),
-                           stereoBuffer.getWritePointer(1),
-                           numSamples, 1);
-        
-        // Copy back to buffer
-        buffer.copyFrom(0, 0, stereoBuffer, 0, 0, numSamples);
-        buffer.copyFrom(1, 0, stereoBuffer, 1, 0, numSamples);
+        // Stereo or multi-channel - process first two channels in place
+        model.processblockreplace(buffer.getReadPointer(0),
+                                  buffer.getReadPointer(1),
+                                  buffer.getWritePointer(0),
+                                  buffer.getWritePointer(1),
+                                  numSamples);
+    }
+}
+
+void FreeverbWrapper::processSend(const juce::AudioBuffer<float>& input,
+                                  juce::AudioBuffer<float>& output,
+                                  float sendLevel)
+{
+    const int numSamples = juce::jmin(input.getNumSamples(), output.getNumSamples());
+    
+    if (input.getNumChannels() == 1 || output.getNumChannels() == 1)
+    {
+        // Mono - both sides read the one channel, and both wet outputs land
+        // on the one output channel, so halve the level to fold them down
+        model.processblockmix(input.getReadPointer(0),
+                              input.getReadPointer(0),
+                              output.getWritePointer(0),
+                              output.getWritePointer(0),
+                              numSamples, sendLevel * 0.5f);
+    }
+    else if (input.getNumChannels() >= 2)
+    {
+        model.processblockmix(input.getReadPointer(0),
+                              input.getReadPointer(1),
+                              output.getWritePointer(0),
+                              output.getWritePointer(1),
+                              numSamples, sendLevel);
     }
-}
\ No newline at end of file
+}
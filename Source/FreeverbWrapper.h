@@ -14,6 +14,18 @@ public:
     void reset();
     void process(juce::AudioBuffer<float>& buffer);
     
+    // Send-style processing: reads input's channels directly and adds the
+    // wet signal, scaled by sendLevel, to output. No copies or resizing.
+    void processSend(const juce::AudioBuffer<float>& input,
+                     juce::AudioBuffer<float>& output,
+                     float sendLevel);
+    
+    // Bytes used by this instance, including the delay lines allocated in prepare
+    size_t getMemoryFootprint();
+    
+    // How long the tail takes to fall by decayDb at the current room size
+    double getTailLengthSeconds(double decayDb = 60.0) { return model.gettaillength(decayDb); }
+    
     // Parameter setters matching JUCE reverb interface
     void setRoomSize(float value) { model.setroomsize(value); }
     void setDamping(float value) { model.setdamp(value); }
@@ -0,0 +1,70 @@
+#include "ModulationLfo.h"
+#include <cmath>
+
+void ModulationLfo::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    
+    if (sineTable.empty())
+    {
+        sineTable.resize((size_t) tableSize + 1);
+        
+        for (int i = 0; i <= tableSize; ++i)
+            sineTable[(size_t) i] = (float) std::sin(juce::MathConstants<double>::twoPi * i / tableSize);
+    }
+    
+    reset();
+}
+
+void ModulationLfo::reset()
+{
+    phase = 0.0f;
+}
+
+void ModulationLfo::setFrequency(float frequencyHz)
+{
+    // Below Nyquist, so a block never wraps more than once per sample
+    increment = (float) juce::jlimit(0.0, 0.5, frequencyHz / sampleRate);
+}
+
+void ModulationLfo::syncToBeat(double ppqPosition, double beatsPerCycle)
+{
+    if (beatsPerCycle <= 0.0)
+        return;
+    
+    const double cycles = ppqPosition / beatsPerCycle;
+    phase = (float) (cycles - std::floor(cycles));
+    
+    // Rounding can land exactly on 1
+    if (phase >= 1.0f)
+        phase = 0.0f;
+}
+
+void ModulationLfo::render(float* dest, int numSamples)
+{
+    // Table positions first, so this loop vectorises; p is never negative,
+    // so truncation wraps it
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float p = phase + (float) i * increment;
+        dest[i] = (p - (float) (int) p) * (float) tableSize;
+    }
+    
+    const float* table = sineTable.data();
+    
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float position = dest[i];
+        const int index = (int) position;
+        const float fraction = position - (float) index;
+        dest[i] = table[index] + fraction * (table[index + 1] - table[index]);
+    }
+    
+    advance(numSamples);
+}
+
+void ModulationLfo::advance(int numSamples)
+{
+    phase += (float) numSamples * increment;
+    phase -= (float) (int) phase;
+}
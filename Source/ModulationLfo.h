@@ -0,0 +1,40 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+// The sine LFO behind the tremolo and smart pan. It has one phase, read from
+// an interpolated table: render() fills a block with sin(phase), computing
+// each sample's phase in closed form, and the consumers turn that curve into
+// gains with a multiply-add per sample. Runs free at a rate in Hz, or locks
+// to the host's beat position for tempo sync.
+class ModulationLfo
+{
+public:
+    ModulationLfo() = default;
+    
+    // Builds the table on first use and resets the phase; not real-time safe
+    void prepare(double sampleRate);
+    void reset();
+    
+    void setFrequency(float frequencyHz);
+    
+    // Sets the phase to where a cycle of beatsPerCycle beats, started at
+    // beat 0, is at ppqPosition
+    void syncToBeat(double ppqPosition, double beatsPerCycle);
+    
+    // Fills dest with the next numSamples values of sin(phase), from -1 to 1,
+    // and advances the phase past them
+    void render(float* dest, int numSamples);
+    
+    // Advances the phase without rendering, to keep time while nothing uses it
+    void advance(int numSamples);
+
+private:
+    static constexpr int tableSize = 1024;  // Power of two, plus a guard point
+    
+    std::vector<float> sineTable;
+    float phase = 0.0f;      // 0-1
+    float increment = 0.0f;  // Per sample
+    double sampleRate = 44100.0;
+};
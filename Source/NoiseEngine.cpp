@@ -0,0 +1,87 @@
+#include "NoiseEngine.h"
+
+namespace
+{
+    // splitmix64, used only to spread a seed over the generator state
+    juce::uint64 splitMix(juce::uint64& x)
+    {
+        auto z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+}
+
+NoiseEngine::NoiseEngine()
+    : baseSeed((juce::uint64) juce::Random::getSystemRandom().nextInt64())
+{
+}
+
+void NoiseEngine::prepare(int numChannels)
+{
+    streams.resize((size_t) numChannels);
+    setSeed(baseSeed);
+}
+
+void NoiseEngine::setSeed(juce::uint64 seed)
+{
+    baseSeed = seed;
+    
+    for (size_t ch = 0; ch < streams.size(); ++ch)
+        seedStream(streams[ch], seed + ch * 0x632be59bd9b4e019ULL);
+}
+
+void NoiseEngine::seedStream(Stream& stream, juce::uint64 seed)
+{
+    for (int lane = 0; lane < lanesPerStream; ++lane)
+    {
+        const auto a = splitMix(seed);
+        const auto b = splitMix(seed);
+        
+        stream.s0[lane] = (uint32_t) a;
+        stream.s1[lane] = (uint32_t) (a >> 32);
+        stream.s2[lane] = (uint32_t) b;
+        stream.s3[lane] = (uint32_t) (b >> 32) | 1u; // State must not be all zero
+    }
+}
+
+// One xoshiro128+ step in every lane
+inline void NoiseEngine::next(Stream& stream, float* dest)
+{
+    constexpr float scale = 1.0f / 2147483648.0f;
+    
+    for (int lane = 0; lane < lanesPerStream; ++lane)
+    {
+        const uint32_t result = stream.s0[lane] + stream.s3[lane];
+        const uint32_t t = stream.s1[lane] << 9;
+        
+        stream.s2[lane] ^= stream.s0[lane];
+        stream.s3[lane] ^= stream.s1[lane];
+        stream.s1[lane] ^= stream.s2[lane];
+        stream.s0[lane] ^= stream.s3[lane];
+        stream.s2[lane] ^= t;
+        stream.s3[lane] = (stream.s3[lane] << 11) | (stream.s3[lane] >> 21);
+        
+        // Signed conversion maps the full 32 bits onto [-1, 1)
+        dest[lane] = (float) (int32_t) result * scale;
+    }
+}
+
+void NoiseEngine::fill(int channel, float* dest, int numSamples)
+{
+    jassert (channel >= 0 && channel < (int) streams.size());
+    auto& stream = streams[(size_t) channel];
+    
+    for (; numSamples >= lanesPerStream; numSamples -= lanesPerStream, dest += lanesPerStream)
+        next(stream, dest);
+    
+    // A partial group: the unused values are simply skipped
+    if (numSamples > 0)
+    {
+        float tail[lanesPerStream];
+        next(stream, tail);
+        
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = tail[i];
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cstdint>
+#include <vector>
+
+// White noise for everything in the processor that needs it. Each channel has
+// its own stream: lanesPerStream xoshiro128+ generators stepped side by side,
+// stored struct-of-arrays so the fill loop auto-vectorises into plain integer
+// SIMD. Output is uniform in [-1, 1).
+//
+// Streams are seeded from a random value at construction, so instances differ;
+// setSeed makes them reproducible.
+class NoiseEngine
+{
+public:
+    static constexpr int lanesPerStream = 8;
+    
+    // Consumers that need noise inside a per-sample loop fill a stack buffer
+    // of this size at a time
+    static constexpr int chunkSize = 256;
+    
+    NoiseEngine();
+    
+    // Allocates one stream per channel; not real-time safe
+    void prepare(int numChannels);
+    void setSeed(juce::uint64 seed);
+    
+    int getNumChannels() const { return (int) streams.size(); }
+    
+    // Fills dest with the next numSamples values of the channel's stream
+    void fill(int channel, float* dest, int numSamples);
+
+private:
+    struct Stream
+    {
+        alignas (32) uint32_t s0[lanesPerStream];
+        alignas (32) uint32_t s1[lanesPerStream];
+        alignas (32) uint32_t s2[lanesPerStream];
+        alignas (32) uint32_t s3[lanesPerStream];
+    };
+    
+    static void seedStream(Stream& stream, juce::uint64 seed);
+    static void next(Stream& stream, float* dest);
+    
+    std::vector<Stream> streams;
+    juce::uint64 baseSeed = 0;
+};
@@ -93,6 +93,17 @@ public:
             float dotY = centreY + (radius + 10) * std::sin(dotAngle);
             g.fillEllipse(dotX - 1.5f, dotY - 1.5f, 3.0f, 3.0f);
         }
+        
+        // 6. Macro marker - where the macro mode is driving this knob
+        const float macroPosition = slider.getProperties().getWithDefault("macroPosition", -1.0f);
+        if (macroPosition >= 0.0f)
+        {
+            float macroAngle = rotaryStartAngle + macroPosition * (rotaryEndAngle - rotaryStartAngle);
+            float markerX = centreX + (radius + 10) * std::cos(macroAngle - juce::MathConstants<float>::halfPi);
+            float markerY = centreY + (radius + 10) * std::sin(macroAngle - juce::MathConstants<float>::halfPi);
+            g.setColour(findColour(juce::Slider::rotarySliderFillColourId));
+            g.fillEllipse(markerX - 3.0f, markerY - 3.0f, 6.0f, 6.0f);
+        }
     }
     
     juce::Font getLabelFont(juce::Label&) override
@@ -158,6 +169,28 @@ public:
         setupKnob(delayMixKnob, delayMixLabel, "DELAY MIX", 0.0, 100.0, 0.01, "%", 9.0f);
         setupKnob(delayFeedbackKnob, delayFeedbackLabel, "FEEDBACK", 0.0, 90.0, 0.01, "%", 9.0f);
         
+        // Tremolo sync selector
+        tremoloSyncCombo.addItem("Free", 1);
+        tremoloSyncCombo.addItem("1/1", 2);
+        tremoloSyncCombo.addItem("1/2", 3);
+        tremoloSyncCombo.addItem("1/4", 4);
+        tremoloSyncCombo.addItem("1/8", 5);
+        tremoloSyncCombo.addItem("1/16", 6);
+        tremoloSyncCombo.addItem("1/32", 7);
+        tremoloSyncCombo.setSelectedId(1); // Default to the free rate
+        tremoloSyncCombo.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2a2a2a));
+        tremoloSyncCombo.setColour(juce::ComboBox::textColourId, juce::Colours::white.withAlpha(0.9f));
+        tremoloSyncCombo.setColour(juce::ComboBox::outlineColourId, juce::Colour(0xff3a3a3a));
+        tremoloSyncCombo.setColour(juce::ComboBox::arrowColourId, juce::Colours::white.withAlpha(0.7f));
+        tremoloSyncCombo.setLookAndFeel(&hardwareLookAndFeel);
+        addAndMakeVisible(tremoloSyncCombo);
+        
+        tremoloSyncLabel.setText("SYNC", juce::dontSendNotification);
+        tremoloSyncLabel.setJustificationType(juce::Justification::centred);
+        tremoloSyncLabel.setColour(juce::Label::textColourId, juce::Colours::white.withAlpha(0.9f));
+        tremoloSyncLabel.setFont(juce::Font(9.0f));
+        addAndMakeVisible(tremoloSyncLabel);
+        
         // Delay time selector
         delayTimeCombo.addItem("1/2", 1);
         delayTimeCombo.addItem("1/3", 2);
@@ -178,13 +211,47 @@ public:
         delayTimeLabel.setFont(juce::Font(9.0f));
         addAndMakeVisible(delayTimeLabel);
         
-        // Vocoder label instead of combo box
-        vocoderLabel.setText("4-BAND VOCODER", juce::dontSendNotification);
+        // Vocoder label and band count selector
+        vocoderLabel.setText("VOCODER", juce::dontSendNotification);
         vocoderLabel.setJustificationType(juce::Justification::centred);
         vocoderLabel.setColour(juce::Label::textColourId, juce::Colours::white.withAlpha(0.9f));
         vocoderLabel.setFont(juce::Font(12.0f, juce::Font::bold));
         addAndMakeVisible(vocoderLabel);
         
+        vocoderBandsCombo.addItem("4 Bands", 1);
+        vocoderBandsCombo.addItem("8 Bands", 2);
+        vocoderBandsCombo.addItem("16 Bands", 3);
+        vocoderBandsCombo.addItem("32 Bands", 4);
+        vocoderBandsCombo.setSelectedId(1);
+        vocoderBandsCombo.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2a2a2a));
+        vocoderBandsCombo.setColour(juce::ComboBox::textColourId, juce::Colours::white.withAlpha(0.9f));
+        vocoderBandsCombo.setColour(juce::ComboBox::outlineColourId, juce::Colour(0xff3a3a3a));
+        vocoderBandsCombo.setColour(juce::ComboBox::arrowColourId, juce::Colours::white.withAlpha(0.7f));
+        vocoderBandsCombo.setLookAndFeel(&hardwareLookAndFeel);
+        addAndMakeVisible(vocoderBandsCombo);
+        
+        vocoderEngineCombo.addItemList(VocoderEngine::getTypeNames(), 1);
+        vocoderEngineCombo.setSelectedId(1);
+        vocoderEngineCombo.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2a2a2a));
+        vocoderEngineCombo.setColour(juce::ComboBox::textColourId, juce::Colours::white.withAlpha(0.9f));
+        vocoderEngineCombo.setColour(juce::ComboBox::outlineColourId, juce::Colour(0xff3a3a3a));
+        vocoderEngineCombo.setColour(juce::ComboBox::arrowColourId, juce::Colours::white.withAlpha(0.7f));
+        vocoderEngineCombo.setLookAndFeel(&hardwareLookAndFeel);
+        addAndMakeVisible(vocoderEngineCombo);
+        
+        vocoderAnalysisRateCombo.addItem("Auto", 1);
+        vocoderAnalysisRateCombo.addItem("Full", 2);
+        vocoderAnalysisRateCombo.addItem("1/2", 3);
+        vocoderAnalysisRateCombo.addItem("1/4", 4);
+        vocoderAnalysisRateCombo.addItem("1/8", 5);
+        vocoderAnalysisRateCombo.setSelectedId(1);
+        vocoderAnalysisRateCombo.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2a2a2a));
+        vocoderAnalysisRateCombo.setColour(juce::ComboBox::textColourId, juce::Colours::white.withAlpha(0.9f));
+        vocoderAnalysisRateCombo.setColour(juce::ComboBox::outlineColourId, juce::Colour(0xff3a3a3a));
+        vocoderAnalysisRateCombo.setColour(juce::ComboBox::arrowColourId, juce::Colours::white.withAlpha(0.7f));
+        vocoderAnalysisRateCombo.setLookAndFeel(&hardwareLookAndFeel);
+        addAndMakeVisible(vocoderAnalysisRateCombo);
+        
         // Riser type selector
         riserTypeCombo.addItem("Sine", 1);
         riserTypeCombo.addItem("Saw", 2);
@@ -258,6 +325,10 @@ public:
         filterSlopeCombo.addItem("12 dB/oct", 2);
         filterSlopeCombo.addItem("18 dB/oct", 3);
         filterSlopeCombo.addItem("24 dB/oct", 4);
+        filterSlopeCombo.addItem("30 dB/oct", 5);
+        filterSlopeCombo.addItem("36 dB/oct", 6);
+        filterSlopeCombo.addItem("42 dB/oct", 7);
+        filterSlopeCombo.addItem("48 dB/oct", 8);
         filterSlopeCombo.setSelectedId(2); // Default to 12 dB/oct
         filterSlopeCombo.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2a2a2a));
         filterSlopeCombo.setColour(juce::ComboBox::textColourId, juce::Colours::white.withAlpha(0.9f));
@@ -272,6 +343,24 @@ public:
         filterSlopeLabel.setFont(juce::Font(9.0f));
         addAndMakeVisible(filterSlopeLabel);
         
+        // Drive oversampling, next to the slope
+        driveOversamplingCombo.addItem("1x", 1);
+        driveOversamplingCombo.addItem("2x", 2);
+        driveOversamplingCombo.addItem("4x", 3);
+        driveOversamplingCombo.setSelectedId(2); // Default to 2x
+        driveOversamplingCombo.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2a2a2a));
+        driveOversamplingCombo.setColour(juce::ComboBox::textColourId, juce::Colours::white.withAlpha(0.9f));
+        driveOversamplingCombo.setColour(juce::ComboBox::outlineColourId, juce::Colour(0xff3a3a3a));
+        driveOversamplingCombo.setColour(juce::ComboBox::arrowColourId, juce::Colours::white.withAlpha(0.7f));
+        driveOversamplingCombo.setLookAndFeel(&hardwareLookAndFeel);
+        addAndMakeVisible(driveOversamplingCombo);
+        
+        driveOversamplingLabel.setText("DRIVE OS", juce::dontSendNotification);
+        driveOversamplingLabel.setJustificationType(juce::Justification::centred);
+        driveOversamplingLabel.setColour(juce::Label::textColourId, juce::Colours::white.withAlpha(0.9f));
+        driveOversamplingLabel.setFont(juce::Font(9.0f));
+        addAndMakeVisible(driveOversamplingLabel);
+        
         // Section labels
         filterSectionLabel.setText("FILTER", juce::dontSendNotification);
         filterSectionLabel.setJustificationType(juce::Justification::centred);
@@ -318,6 +407,8 @@ public:
             processor.parameters, "tremoloRate", tremoloRateKnob);
         tremoloDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
             processor.parameters, "tremoloDepth", tremoloDepthKnob);
+        tremoloSyncAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            processor.parameters, "tremoloSync", tremoloSyncCombo);
         riserAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
             processor.parameters, "riserAmount", riserKnob);
         riserReleaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
@@ -345,8 +436,16 @@ public:
             processor.parameters, "delayFeedback", delayFeedbackKnob);
         delayTimeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
             processor.parameters, "delayTime", delayTimeCombo);
+        vocoderBandsAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            processor.parameters, "vocoderBands", vocoderBandsCombo);
+        vocoderEngineAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            processor.parameters, "vocoderEngine", vocoderEngineCombo);
+        vocoderAnalysisRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            processor.parameters, "vocoderAnalysisRate", vocoderAnalysisRateCombo);
         filterSlopeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
             processor.parameters, "filterSlope", filterSlopeCombo);
+        driveOversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            processor.parameters, "driveOversampling", driveOversamplingCombo);
         autoGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
             processor.parameters, "autoGain", autoGainButton);
         macroModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
@@ -398,9 +497,41 @@ public:
         nextButton.setLookAndFeel(nullptr);
         filterTypeCombo.setLookAndFeel(nullptr);
         filterSlopeCombo.setLookAndFeel(nullptr);
+        driveOversamplingCombo.setLookAndFeel(nullptr);
         riserTypeCombo.setLookAndFeel(nullptr);
+        tremoloSyncCombo.setLookAndFeel(nullptr);
         autoGainButton.setLookAndFeel(nullptr);
         macroModeCombo.setLookAndFeel(nullptr);
+        vocoderBandsCombo.setLookAndFeel(nullptr);
+        vocoderEngineCombo.setLookAndFeel(nullptr);
+        vocoderAnalysisRateCombo.setLookAndFeel(nullptr);
+    }
+    
+    // Polls the processor's macro layer and moves each knob's macro marker
+    void updateMacroMarkers()
+    {
+        using Processor = BuildUpVerbAudioProcessor;
+        const std::pair<Processor::MacroTarget, juce::Slider*> targets[] = {
+            { Processor::macroFilterIntensity, &filterKnob },
+            { Processor::macroReverbMix, &reverbKnob },
+            { Processor::macroNoiseAmount, &noiseKnob },
+            { Processor::macroFilterResonance, &resonanceKnob },
+            { Processor::macroStereoWidth, &widthKnob },
+            { Processor::macroRiserAmount, &riserKnob },
+            { Processor::macroTremoloDepth, &tremoloDepthKnob }
+        };
+        
+        for (const auto& [target, knob] : targets)
+        {
+            const float position = processor.getMacroModulation(target);
+            auto& properties = knob->getProperties();
+            
+            if ((float) properties.getWithDefault("macroPosition", -1.0f) != position)
+            {
+                properties.set("macroPosition", position);
+                knob->repaint();
+            }
+        }
     }
     
     void paint(juce::Graphics& g) override
@@ -627,6 +758,10 @@ public:
         // Filter slope as toggle buttons below
         filterSection.removeFromTop(5);
         auto filterSlopeRow = filterSection.removeFromTop(35).reduced(3, 0);
+        auto driveOversamplingRow = filterSlopeRow.removeFromRight(filterSlopeRow.getWidth() / 3);
+        driveOversamplingRow.removeFromLeft(3);
+        driveOversamplingLabel.setBounds(driveOversamplingRow.removeFromBottom(12));
+        driveOversamplingCombo.setBounds(driveOversamplingRow);
         filterSlopeLabel.setBounds(filterSlopeRow.removeFromBottom(12));
         filterSlopeCombo.setBounds(filterSlopeRow);
         
@@ -653,8 +788,12 @@ public:
         auto vocoderBrightnessArea = noiseRow.removeFromLeft(65);
         layoutKnob(vocoderBrightnessKnob, vocoderBrightnessLabel, vocoderBrightnessArea, smallKnobSize);
         
-        // Vocoder label
+        // Vocoder label, engine, analysis rate and band count
         auto vocoderArea = noiseSection.reduced(5, 0);
+        vocoderEngineCombo.setBounds(vocoderArea.removeFromLeft(100).withSizeKeepingCentre(100, 24));
+        vocoderArea.removeFromLeft(5);
+        vocoderAnalysisRateCombo.setBounds(vocoderArea.removeFromLeft(60).withSizeKeepingCentre(60, 24));
+        vocoderBandsCombo.setBounds(vocoderArea.removeFromRight(100).withSizeKeepingCentre(100, 24));
         vocoderLabel.setBounds(vocoderArea);
         
         // Add spacing between rows
@@ -675,6 +814,11 @@ public:
         auto depthArea = tremoloRow.removeFromLeft(80);
         layoutKnob(tremoloDepthKnob, tremoloDepthLabel, depthArea, knobSize);
         
+        // Tremolo sync dropdown
+        auto tremoloSyncArea = tremoloSection.reduced(5, 0);
+        tremoloSyncLabel.setBounds(tremoloSyncArea.removeFromBottom(15));
+        tremoloSyncCombo.setBounds(tremoloSyncArea);
+        
         // Add gap between sections
         bottomRow.removeFromLeft(20);
         
@@ -828,10 +972,19 @@ private:
     juce::Label tremoloRateLabel, tremoloDepthLabel, riserLabel, riserReleaseLabel;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> tremoloRateAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> tremoloDepthAttachment;
+    juce::ComboBox tremoloSyncCombo;
+    juce::Label tremoloSyncLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> tremoloSyncAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> riserAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> riserReleaseAttachment;
     
     juce::Label vocoderLabel;
+    juce::ComboBox vocoderBandsCombo;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> vocoderBandsAttachment;
+    juce::ComboBox vocoderEngineCombo;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> vocoderEngineAttachment;
+    juce::ComboBox vocoderAnalysisRateCombo;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> vocoderAnalysisRateAttachment;
     
     juce::ComboBox riserTypeCombo;
     juce::Label riserTypeLabel;
@@ -860,7 +1013,10 @@ private:
     // Filter slope
     juce::ComboBox filterSlopeCombo;
     juce::Label filterSlopeLabel;
+    juce::ComboBox driveOversamplingCombo;
+    juce::Label driveOversamplingLabel;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> filterSlopeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> driveOversamplingAttachment;
     
     juce::ToggleButton autoGainButton;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> autoGainAttachment;
@@ -891,6 +1047,9 @@ BuildUpVerbAudioProcessorEditor::BuildUpVerbAudioProcessorEditor (BuildUpVerbAud
     
     setSize (900, 750);  // Wider layout for sections with delay
     setResizable (false, false);
+    
+    // Macro markers follow the audio thread
+    startTimerHz (30);
 }
 
 BuildUpVerbAudioProcessorEditor::~BuildUpVerbAudioProcessorEditor()
@@ -920,7 +1079,7 @@ void BuildUpVerbAudioProcessorEditor::loadWebContent()
 
 void BuildUpVerbAudioProcessorEditor::timerCallback()
 {
-    // Not used in native implementation
+    knobComp->updateMacroMarkers();
 }
 
 void BuildUpVerbAudioProcessorEditor::sendParameterUpdate()
@@ -21,27 +21,58 @@ BuildUpVerbAudioProcessor::BuildUpVerbAudioProcessor()
      : AudioProcessor (BusesProperties()
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)),
-       parameters (*this, nullptr, juce::Identifier ("BuildUpVerb"), createParameterLayout()),
-       forwardFFT (fftOrder),
-       fftData (fftSize * 2),
-       window (fftSize),
-       frequencyData (fftSize / 2 + 1),
-       magnitudes (fftSize / 2 + 1),
-       phases (fftSize / 2 + 1),
-       bandLevels (numBands),
-       smoothedBandLevels (numBands),
-       overlapBuffer (fftSize * 2, 0.0f),  // Stereo overlap buffer
-       prevPhases (fftSize / 2 + 1, 0.0f),
-       inputBuffer (fftSize * 2, 0.0f),    // Stereo input buffer
-       outputBuffer (fftSize * 2, 0.0f)    // Stereo output buffer
+       parameters (*this, nullptr, juce::Identifier ("BuildUpVerb"), createParameterLayout())
 {
-    // Create Hann window
-    for (int i = 0; i < fftSize; ++i)
-        window[i] = 0.5f - 0.5f * std::cos(2.0f * juce::MathConstants<float>::pi * i / (fftSize - 1));
+    auto resolve = [this] (const char* parameterID)
+    {
+        auto* value = parameters.getRawParameterValue (parameterID);
+        jassert (value != nullptr); // ID missing from createParameterLayout
+        return value;
+    };
+    
+    parameterHandles.buildUp = resolve ("buildup");
+    parameterHandles.filterIntensity = resolve ("filterIntensity");
+    parameterHandles.filterResonance = resolve ("filterResonance");
+    parameterHandles.filterType = resolve ("filterType");
+    parameterHandles.filterSlope = resolve ("filterSlope");
+    parameterHandles.filterDrive = resolve ("filterDrive");
+    parameterHandles.driveOversampling = resolve ("driveOversampling");
+    parameterHandles.reverbMix = resolve ("reverbMix");
+    parameterHandles.noiseAmount = resolve ("noiseAmount");
+    parameterHandles.vocoderRelease = resolve ("vocoderRelease");
+    parameterHandles.vocoderBrightness = resolve ("vocoderBrightness");
+    parameterHandles.vocoderBands = resolve ("vocoderBands");
+    parameterHandles.vocoderAnalysisRate = resolve ("vocoderAnalysisRate");
+    parameterHandles.vocoderEngine = resolve ("vocoderEngine");
+    parameterHandles.tremoloRate = resolve ("tremoloRate");
+    parameterHandles.tremoloDepth = resolve ("tremoloDepth");
+    parameterHandles.tremoloSync = resolve ("tremoloSync");
+    parameterHandles.riserAmount = resolve ("riserAmount");
+    parameterHandles.riserType = resolve ("riserType");
+    parameterHandles.riserRelease = resolve ("riserRelease");
+    parameterHandles.stereoWidth = resolve ("stereoWidth");
+    parameterHandles.smartPan = resolve ("smartPan");
+    parameterHandles.noiseGate = resolve ("noiseGate");
+    parameterHandles.autoGain = resolve ("autoGain");
+    parameterHandles.macroMode = resolve ("macroMode");
+    parameterHandles.delayMix = resolve ("delayMix");
+    parameterHandles.delayTime = resolve ("delayTime");
+    parameterHandles.delayFeedback = resolve ("delayFeedback");
+    
+    const char* macroTargetIDs[numMacroTargets] = { "filterIntensity", "reverbMix", "noiseAmount", "filterResonance",
+                                                    "stereoWidth", "riserAmount", "tremoloDepth" };
+    
+    for (size_t i = 0; i < macroParameters.size(); ++i)
+    {
+        macroParameters[i] = parameters.getParameter (macroTargetIDs[i]);
+        jassert (macroParameters[i] != nullptr);
+        macroModulation[i] = -1.0f;
+    }
 }
 
 BuildUpVerbAudioProcessor::~BuildUpVerbAudioProcessor()
 {
+    cancelPendingUpdate();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout BuildUpVerbAudioProcessor::createParameterLayout()
@@ -63,9 +94,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout BuildUpVerbAudioProcessor::c
                                                               juce::StringArray {"High Pass", "Low Pass", "Dual Sweep"},
                                                               0));
     
+    // 30-48 dB/oct were appended after the original four, so saved sessions
+    // (which store the choice index) keep their slope. Host automation is
+    // normalised over the choice count, so lanes recorded against the
+    // four-choice version land on different slopes.
     layout.add (std::make_unique<juce::AudioParameterChoice> ("filterSlope",
                                                               "Filter Slope",
-                                                              juce::StringArray {"6 dB/oct", "12 dB/oct", "18 dB/oct", "24 dB/oct"},
+                                                              juce::StringArray {"6 dB/oct", "12 dB/oct", "18 dB/oct", "24 dB/oct",
+                                                                                 "30 dB/oct", "36 dB/oct", "42 dB/oct", "48 dB/oct"},
                                                               1)); // Default to 12 dB/oct
     
     layout.add (std::make_unique<juce::AudioParameterFloat> ("reverbMix",
@@ -90,6 +126,23 @@ juce::AudioProcessorValueTreeState::ParameterLayout BuildUpVerbAudioProcessor::c
                                                              juce::NormalisableRange<float> (0.0f, 100.0f, 0.01f),
                                                              50.0f)); // Default to balanced
     
+    layout.add (std::make_unique<juce::AudioParameterChoice> ("vocoderBands",
+                                                              "Vocoder Bands",
+                                                              juce::StringArray {"4 Bands", "8 Bands", "16 Bands", "32 Bands"},
+                                                              0)); // 4 bands like Ableton
+    
+    layout.add (std::make_unique<juce::AudioParameterChoice> ("vocoderEngine",
+                                                              "Vocoder Engine",
+                                                              VocoderEngine::getTypeNames(),
+                                                              0)); // Filterbank
+    
+    // Filterbank envelope follower rate: Auto keeps it near 48kHz, the rest
+    // step the followers every 1, 2, 4 or 8 samples
+    layout.add (std::make_unique<juce::AudioParameterChoice> ("vocoderAnalysisRate",
+                                                              "Vocoder Analysis Rate",
+                                                              juce::StringArray {"Auto", "Full", "1/2", "1/4", "1/8"},
+                                                              0));
+    
     layout.add (std::make_unique<juce::AudioParameterFloat> ("tremoloRate",
                                                              "Tremolo Rate",
                                                              juce::NormalisableRange<float> (0.1f, 20.0f, 0.01f, 0.5f),
@@ -100,6 +153,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout BuildUpVerbAudioProcessor::c
                                                              juce::NormalisableRange<float> (0.0f, 100.0f, 0.01f),
                                                              0.0f));
     
+    layout.add (std::make_unique<juce::AudioParameterChoice> ("tremoloSync",
+                                                              "Tremolo Sync",
+                                                              juce::StringArray {"Free", "1/1", "1/2", "1/4", "1/8", "1/16", "1/32"},
+                                                              0)); // Default to the free rate
+    
     layout.add (std::make_unique<juce::AudioParameterFloat> ("riserAmount",
                                                              "Riser Amount",
                                                              juce::NormalisableRange<float> (0.0f, 100.0f, 0.01f),
@@ -125,10 +183,10 @@ juce::AudioProcessorValueTreeState::ParameterLayout BuildUpVerbAudioProcessor::c
                                                              juce::NormalisableRange<float> (0.0f, 100.0f, 0.01f),
                                                              0.0f));
     
-    layout.add (std::make_unique<juce::AudioParameterChoice> ("filterSlope",
-                                                              "Filter Slope",
-                                                              juce::StringArray {"6dB", "12dB", "18dB", "24dB"},
-                                                              1)); // Default to 12dB
+    layout.add (std::make_unique<juce::AudioParameterChoice> ("driveOversampling",
+                                                              "Drive Oversampling",
+                                                              juce::StringArray {"1x", "2x", "4x"},
+                                                              0)); // No added latency unless asked for
     
     layout.add (std::make_unique<juce::AudioParameterFloat> ("stereoWidth",
                                                              "Stereo Width",
@@ -194,7 +252,7 @@ bool BuildUpVerbAudioProcessor::isMidiEffect() const
 
 double BuildUpVerbAudioProcessor::getTailLengthSeconds() const
 {
-    return 5.0; // Reverb tail
+    return tailLengthSeconds.load(); // Reverb/delay tail, tracked in processBlock
 }
 
 int BuildUpVerbAudioProcessor::getNumPrograms()
@@ -254,50 +312,156 @@ void BuildUpVerbAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
     spec.maximumBlockSize = samplesPerBlock;
     spec.numChannels = getTotalNumOutputChannels();
     
+    // processBlock gets max(in, out) channels, so size scratch space for that
+    scratchBuffers.prepare (juce::jmax (getTotalNumInputChannels(), getTotalNumOutputChannels()), samplesPerBlock);
+    
     freeverb.prepare (sampleRate, samplesPerBlock);
-    highPassFilter.prepare (spec);
-    lowPassFilter.prepare (spec);
-    highPassFilter2.prepare (spec);
-    highPassFilter3.prepare (spec);
-    highPassFilter4.prepare (spec);
-    lowPassFilter2.prepare (spec);
-    lowPassFilter3.prepare (spec);
-    lowPassFilter4.prepare (spec);
-    
-    highPassFilter.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-    highPassFilter2.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-    highPassFilter3.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-    highPassFilter4.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-    lowPassFilter.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
-    lowPassFilter2.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
-    lowPassFilter3.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
-    lowPassFilter4.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
+    
+    driveStage.prepare (sampleRate, juce::jmax (getTotalNumInputChannels(), getTotalNumOutputChannels()), samplesPerBlock);
+    driveStage.setOversamplingOrder ((int) parameterHandles.driveOversampling->load());
+    
+    // Vocoder state is per channel and per instance, re-prepared for every new rate/block size
+    const int numProcessChannels = juce::jmax (getTotalNumInputChannels(), getTotalNumOutputChannels());
+    noiseEngine.prepare (numProcessChannels);
+    preparedSampleRate = sampleRate;
+    preparedNumChannels = numProcessChannels;
+    cancelPendingUpdate();
+    
+    // Keep the engine if it's still the selected one; prepare reallocates
+    // its state for the new rate and channel count
+    if (vocoderEngine != nullptr && getSelectedVocoderEngine() == vocoderEngineType)
+    {
+        const juce::SpinLock::ScopedLockType lock (vocoderEngineLock);
+        vocoderEngine->prepare (sampleRate, numProcessChannels);
+    }
+    else
+    {
+        rebuildVocoderEngine();
+    }
+    
+    updateLatency();
+    vocoderActive = false;
+    smoothEnvelopeGate = 0.0f;
+    buildUpFilter.prepare (sampleRate, numProcessChannels);
+    
+    riserOscillators.prepare (sampleRate);
+    tremoloLfo.prepare (sampleRate);
     
     // Initialize noise filter for noise sweep riser
-    noiseFilter.prepare (spec);
+    noiseFilter.prepare ({ sampleRate, (juce::uint32) samplesPerBlock, 1 });
     noiseFilter.setType (juce::dsp::StateVariableTPTFilterType::bandpass);
     
-    // Initialize delay buffers (up to 2 seconds at any sample rate)
-    int maxDelaySamples = (int)(sampleRate * 2.0);
-    delayBufferL.setSize(1, maxDelaySamples);
-    delayBufferR.setSize(1, maxDelaySamples);
-    delayBufferL.clear();
-    delayBufferR.clear();
-    delayWritePos = 0;
-    
-    // Initialize FFT buffers for vocoder
-    fftInputBuffer.setSize(2, fftSize);
-    fftOutputBuffer.setSize(2, fftSize);
-    fftInputBuffer.clear();
-    fftOutputBuffer.clear();
-    
-    updateDSPFromParameters();
+    // Initialize delay lines (up to 2 seconds at any sample rate), one per channel
+    tempoDelay.prepare (sampleRate, numProcessChannels);
+    
+    silentSamples = 0;
+    isIdle = false;
+    
+    invalidateControls();
+    updateDSPFromParameters (loadParameters());
 }
 
 void BuildUpVerbAudioProcessor::releaseResources()
 {
 }
 
+BuildUpVerbAudioProcessor::ParameterSnapshot BuildUpVerbAudioProcessor::loadParameters() const
+{
+    // Relaxed loads: each value only needs to be recent, not ordered
+    // against the others
+    auto load = [] (const std::atomic<float>* value) { return value->load (std::memory_order_relaxed); };
+    const auto& handles = parameterHandles;
+    
+    ParameterSnapshot snapshot;
+    snapshot.buildUp = load (handles.buildUp);
+    snapshot.filterIntensity = load (handles.filterIntensity);
+    snapshot.filterResonance = load (handles.filterResonance);
+    snapshot.filterType = (int) load (handles.filterType);
+    snapshot.filterSlope = (int) load (handles.filterSlope);
+    snapshot.filterDrive = load (handles.filterDrive);
+    snapshot.driveOversampling = (int) load (handles.driveOversampling);
+    snapshot.reverbMix = load (handles.reverbMix);
+    snapshot.noiseAmount = load (handles.noiseAmount);
+    snapshot.vocoderRelease = load (handles.vocoderRelease);
+    snapshot.vocoderBrightness = load (handles.vocoderBrightness);
+    snapshot.vocoderBands = (int) load (handles.vocoderBands);
+    snapshot.vocoderAnalysisRate = (int) load (handles.vocoderAnalysisRate);
+    snapshot.tremoloRate = load (handles.tremoloRate);
+    snapshot.tremoloDepth = load (handles.tremoloDepth);
+    snapshot.tremoloSync = (int) load (handles.tremoloSync);
+    snapshot.riserAmount = load (handles.riserAmount);
+    snapshot.riserType = (int) load (handles.riserType);
+    snapshot.riserRelease = load (handles.riserRelease);
+    snapshot.stereoWidth = load (handles.stereoWidth);
+    snapshot.smartPan = load (handles.smartPan);
+    snapshot.noiseGate = load (handles.noiseGate);
+    snapshot.autoGain = load (handles.autoGain) > 0.5f;
+    snapshot.macroMode = (int) load (handles.macroMode);
+    snapshot.delayMix = load (handles.delayMix);
+    snapshot.delayTime = (int) load (handles.delayTime);
+    snapshot.delayFeedback = load (handles.delayFeedback);
+    return snapshot;
+}
+
+VocoderEngine::Type BuildUpVerbAudioProcessor::getSelectedVocoderEngine() const
+{
+    return (VocoderEngine::Type) (int) parameterHandles.vocoderEngine->load (std::memory_order_relaxed);
+}
+
+void BuildUpVerbAudioProcessor::rebuildVocoderEngine()
+{
+    if (preparedSampleRate <= 0.0)
+        return;
+    
+    const auto type = getSelectedVocoderEngine();
+    auto engine = VocoderEngine::create (type, noiseEngine);
+    engine->prepare (preparedSampleRate, preparedNumChannels);
+    
+    {
+        const juce::SpinLock::ScopedLockType lock (vocoderEngineLock);
+        std::swap (vocoderEngine, engine);
+        vocoderEngineType = type;
+    }
+    
+    // engine now holds the previous one, freed here rather than on the audio thread
+}
+
+void BuildUpVerbAudioProcessor::updateLatency()
+{
+    // The drive stage delays the whole signal. The vocoder's own lag (one
+    // frame for the spectral engine) isn't reported: no other path is
+    // delayed to match it, so the host would pull everything else early.
+    const int driveOrder = (int) parameterHandles.driveOversampling->load();
+    setLatencySamples (driveStage.getLatencySamples (driveOrder));
+}
+
+void BuildUpVerbAudioProcessor::addRiserVoice (juce::AudioBuffer<float>& buffer, RiserOscillatorBank::Voice voice,
+                                               float startFreq, float endFreq, float gain)
+{
+    const int numSamples = buffer.getNumSamples();
+    auto* voiceData = scratchBuffers.get (ScratchBuffers::riserVoice, 1, numSamples).getWritePointer (0);
+    riserOscillators.render (voice, voiceData, numSamples, startFreq, endFreq);
+    
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        juce::FloatVectorOperations::addWithMultiply (buffer.getWritePointer (channel), voiceData, gain, numSamples);
+}
+
+void BuildUpVerbAudioProcessor::handleAsyncUpdate()
+{
+    if (getSelectedVocoderEngine() != vocoderEngineType)
+        rebuildVocoderEngine();
+    
+    updateLatency();
+    
+    const double tail = tailLengthSeconds.load();
+    
+    if (tail != hostTailSeconds)
+    {
+        hostTailSeconds = tail;
+        updateHostDisplay (ChangeDetails().withNonParameterStateChanged (true));
+    }
+}
+
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool BuildUpVerbAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
@@ -316,47 +480,84 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
 {
     juce::ScopedNoDenormals noDenormals;
     
+    // One consistent set of parameter values for the whole block, with the
+    // macro mode's modulation applied on top
+    auto params = loadParameters();
+    
     // Get buildup value first for immediate bypass check
-    float buildUp = *parameters.getRawParameterValue ("buildup");
+    float buildUp = params.buildUp;
     float buildUpNorm = buildUp / 100.0f;
     
+    applyMacroModulation (params, buildUpNorm, params.macroMode);
+    
     // Smooth the build up parameter to prevent clicks
     const float buildUpSmoothCoeff = 0.995f; // Very smooth
     smoothedBuildUp = smoothedBuildUp * buildUpSmoothCoeff + buildUpNorm * (1.0f - buildUpSmoothCoeff);
     
+    // Land exactly on the target once close, so the reverb settings stop
+    // changing and updateDSPFromParameters can skip them
+    if (std::abs(smoothedBuildUp - buildUpNorm) < 1.0e-4f)
+        smoothedBuildUp = buildUpNorm;
+    
     // Immediate bypass - if Build Up is 0, pass through without ANY processing
+    // beyond the drive stage's latency-matched delay, so the reported latency holds
     if (buildUpNorm < 0.001f)
     {
-        return; // Input buffer passes through untouched
+        driveStage.process (buffer, 0.0f);
+        return;
+    }
+    
+    // Idle sleep - once the input has been silent for longer than every tail
+    // and nothing generates sound on its own, there's nothing left to compute
+    {
+        const bool riserActive = params.riserAmount > 0.01f || currentRiserLevel > 0.01f;
+        const bool inputSilent = buffer.getMagnitude (0, buffer.getNumSamples()) < silenceThreshold;
+        
+        if (inputSilent && ! riserActive)
+        {
+            if (isIdle)
+                return;
+            silentSamples = juce::jmin (silentSamples + buffer.getNumSamples(),
+                                        std::numeric_limits<int>::max() / 2);
+        }
+        else
+        {
+            silentSamples = 0;
+            isIdle = false;
+        }
     }
     
-    updateDSPFromParameters();
+    updateDSPFromParameters (params);
     
-    // Get macro mode early for the control system
-    int macroMode = (int)*parameters.getRawParameterValue ("macroMode");
+    // A different vocoder was selected: build it off the audio thread
+    if (getSelectedVocoderEngine() != vocoderEngineType)
+        triggerAsyncUpdate();
     
-    // Apply macro control if enabled
-    if (macroMode > 0 && std::abs(buildUp - lastMacroValue) > 0.01f)
+    // The drive stage switches oversamplers at once; the host hears about
+    // the new latency from the message thread
+    if (params.driveOversampling != driveStage.getOversamplingOrder())
     {
-        lastMacroValue = buildUp;
-        applyMacroControl(buildUpNorm, macroMode);
+        driveStage.setOversamplingOrder (params.driveOversampling);
+        triggerAsyncUpdate();
     }
-    float filterIntensity = *parameters.getRawParameterValue ("filterIntensity");
-    float reverbMix = *parameters.getRawParameterValue ("reverbMix");
-    float noiseAmount = *parameters.getRawParameterValue ("noiseAmount");
+    
+    float filterIntensity = params.filterIntensity;
+    float reverbMix = params.reverbMix;
+    float noiseAmount = params.noiseAmount;
     // Noise type removed - always vocoder now
-    float tremoloRate = *parameters.getRawParameterValue ("tremoloRate");
-    float tremoloDepth = *parameters.getRawParameterValue ("tremoloDepth");
-    float riserAmount = *parameters.getRawParameterValue ("riserAmount");
-    int riserType = (int)*parameters.getRawParameterValue ("riserType");
-    float riserRelease = *parameters.getRawParameterValue ("riserRelease");
-    float stereoWidth = *parameters.getRawParameterValue ("stereoWidth");
-    float smartPan = *parameters.getRawParameterValue ("smartPan");
-    float noiseGate = *parameters.getRawParameterValue ("noiseGate");
-    bool autoGain = *parameters.getRawParameterValue ("autoGain") > 0.5f;
-    float delayMix = *parameters.getRawParameterValue ("delayMix");
-    int delayTimeChoice = (int)*parameters.getRawParameterValue ("delayTime");
-    float delayFeedback = *parameters.getRawParameterValue ("delayFeedback");
+    float tremoloRate = params.tremoloRate;
+    float tremoloDepth = params.tremoloDepth;
+    int tremoloSync = params.tremoloSync;
+    float riserAmount = params.riserAmount;
+    int riserType = params.riserType;
+    float riserRelease = params.riserRelease;
+    float stereoWidth = params.stereoWidth;
+    float smartPan = params.smartPan;
+    float noiseGate = params.noiseGate;
+    bool autoGain = params.autoGain;
+    float delayMix = params.delayMix;
+    int delayTimeChoice = params.delayTime;
+    float delayFeedback = params.delayFeedback;
     
     // buildUpNorm already declared at the top
     float filterIntensityNorm = filterIntensity / 100.0f;
@@ -399,7 +600,6 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     float envelopeGate = (envelopeLevel > dynamicThreshold) ? 1.0f : 0.0f;
     
     // Very fast gate transitions - almost instant noise cutoff
-    static float smoothEnvelopeGate = 0.0f;
     smoothEnvelopeGate += (envelopeGate - smoothEnvelopeGate) * 0.9f; // Near-instant gate response
     
     // NOTE: Reverb buffer creation moved to AFTER noise generation
@@ -408,63 +608,29 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     // Process intelligent filter automation (controlled by filter intensity)
     if (filterIntensityNorm > 0.01f)
     {
-        int filterType = (int)*parameters.getRawParameterValue ("filterType");
-        int filterSlope = (int)*parameters.getRawParameterValue ("filterSlope");
-        float filterDrive = *parameters.getRawParameterValue ("filterDrive");
+        int filterType = params.filterType;
+        int filterSlope = params.filterSlope;
+        float filterDrive = params.filterDrive;
         float driveNorm = filterDrive / 100.0f;
         
-        // Apply pre-drive saturation if enabled
-        if (driveNorm > 0.01f)
-        {
-            float driveGain = 1.0f + driveNorm * 4.0f; // Up to 5x gain
-            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-            {
-                auto* data = buffer.getWritePointer(channel);
-                for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-                {
-                    // Soft clip saturation
-                    float driven = data[sample] * driveGain;
-                    data[sample] = std::tanh(driven) / (1.0f + driveNorm * 0.5f); // Compensate gain
-                }
-            }
-        }
+        // Apply pre-drive saturation if enabled (oversampled, see DriveStage)
+        driveStage.process (buffer, driveNorm);
         
-        // filterSlope: 0 = 6dB (1 stage), 1 = 12dB (2 stages), 2 = 18dB (3 stages), 3 = 24dB (4 stages)
+        // filterSlope: 0 = 6dB (1 stage), 1 = 12dB (2 stages) ... 7 = 48dB (8 stages)
         // Each stage provides 6dB/octave of attenuation
         int numStages = filterSlope + 1;
         
-        // Create filter context
-        juce::dsp::AudioBlock<float> filterBlock (buffer);
-        juce::dsp::ProcessContextReplacing<float> filterContext (filterBlock);
-        
-        if (filterType == 2) // Band Pass - use dual-filter automation
-        {
-            // Apply high-pass stages
-            highPassFilter.process (filterContext);
-            if (numStages >= 2) highPassFilter2.process (filterContext);
-            if (numStages >= 3) highPassFilter3.process (filterContext);
-            if (numStages >= 4) highPassFilter4.process (filterContext);
-            
-            // Apply low-pass stages
-            lowPassFilter.process (filterContext);
-            if (numStages >= 2) lowPassFilter2.process (filterContext);
-            if (numStages >= 3) lowPassFilter3.process (filterContext);
-            if (numStages >= 4) lowPassFilter4.process (filterContext);
-        }
-        else if (filterType == 0) // High Pass only
-        {
-            highPassFilter.process (filterContext);
-            if (numStages >= 2) highPassFilter2.process (filterContext);
-            if (numStages >= 3) highPassFilter3.process (filterContext);
-            if (numStages >= 4) highPassFilter4.process (filterContext);
-        }
-        else if (filterType == 1) // Low Pass only
-        {
-            lowPassFilter.process (filterContext);
-            if (numStages >= 2) lowPassFilter2.process (filterContext);
-            if (numStages >= 3) lowPassFilter3.process (filterContext);
-            if (numStages >= 4) lowPassFilter4.process (filterContext);
-        }
+        // High pass only, low pass only, or both for the dual sweep - every
+        // active stage runs in a single pass over the block
+        const int numHighPassStages = (filterType == 0 || filterType == 2) ? numStages : 0;
+        const int numLowPassStages = (filterType == 1 || filterType == 2) ? numStages : 0;
+        buildUpFilter.process (buffer, numHighPassStages, numLowPassStages);
+    }
+    else
+    {
+        // No drive: the drive stage only delays the signal by the latency the
+        // host was given, without running the oversampler
+        driveStage.process (buffer, 0.0f);
     }
     
     // True FFT Vocoder - linked to Build Up
@@ -473,43 +639,33 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
         // Vocoder gain based on build up AND noise amount
         // Use raw buildUpNorm instead of smoothedBuildUp to prevent modulation
         float vocoderGain = buildUpNorm * noiseAmountNorm;
-        float vocoderReleaseAmount = *parameters.getRawParameterValue ("vocoderRelease") / 100.0f;
-        float vocoderBrightness = *parameters.getRawParameterValue ("vocoderBrightness") / 100.0f;
+        float vocoderReleaseAmount = params.vocoderRelease / 100.0f;
+        float vocoderBrightness = params.vocoderBrightness / 100.0f;
+        int vocoderBandsChoice = params.vocoderBands;
         
-        // Create buffer for vocoder output
-        juce::AudioBuffer<float> noiseBuffer(buffer.getNumChannels(), buffer.getNumSamples());
-        noiseBuffer.clear();
+        VocoderEngine::Parameters vocoderParameters;
+        vocoderParameters.gain = vocoderGain;
+        vocoderParameters.release = vocoderReleaseAmount;
+        vocoderParameters.brightness = vocoderBrightness;
+        vocoderParameters.numBands = 4 << vocoderBandsChoice; // 4, 8, 16 or 32
+        vocoderParameters.envelopeDecimation = params.vocoderAnalysisRate == 0 ? 0 : 1 << (params.vocoderAnalysisRate - 1);
         
-        // Process vocoder - use filterbank for 4-band like Ableton
-        processVocoderFilterbank(buffer, noiseBuffer, vocoderGain, vocoderReleaseAmount, vocoderBrightness);
+        // Scratch buffer for vocoder output
+        auto& noiseBuffer = scratchBuffers.get (ScratchBuffers::vocoderOutput, numChannels, numSamples);
+        noiseBuffer.clear();
         
-        // BYPASS FILTERING FOR NOW TO TEST IF THIS IS THE ISSUE
-        // The filters might be causing the ringing with high resonance
-        /*
-        // Apply filtering to noise based on Build Up position
-        if (filterIntensityNorm > 0.01f && buildUpNorm > 0.01f)
+        // Process the selected vocoder engine. While a new engine is being
+        // swapped in, this block goes without.
         {
-            // Use the same filter settings as the main signal
-            int filterType = (int)*parameters.getRawParameterValue ("filterType");
-            float filterAmount = buildUpNorm * filterIntensityNorm;
-            
-            juce::dsp::AudioBlock<float> noiseBlock(noiseBuffer);
-            juce::dsp::ProcessContextReplacing<float> noiseContext(noiseBlock);
+            const juce::SpinLock::ScopedTryLockType engineLock (vocoderEngineLock);
             
-            // Apply the same filter that was applied to the main signal
-            if (filterType == 0 || filterType == 2) // High pass or dual
-            {
-                highPassFilter.process(noiseContext);
-            }
-            if (filterType == 1 || filterType == 2) // Low pass or dual  
-            {
-                lowPassFilter.process(noiseContext);
-            }
+            if (engineLock.isLocked() && vocoderEngine != nullptr)
+                vocoderEngine->process (buffer, noiseBuffer, vocoderParameters);
         }
-        */
         
+        vocoderActive = true;
         
-        // Mix filtered noise into main buffer
+        // Mix the vocoded noise into the main buffer
         for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
         {
             auto* mainData = buffer.getWritePointer(channel);
@@ -521,32 +677,33 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
             }
         }
     }
-    else
+    else if (vocoderActive)
     {
-        // Reset vocoder band levels when build up is off
-        std::fill(smoothedBandLevels.begin(), smoothedBandLevels.end(), 0.0f);
-        fftPos = 0;
+        // Clear the vocoder's history when build up turns it off, so nothing
+        // stale (like the STFT's buffered frame) plays when it comes back
+        const juce::SpinLock::ScopedTryLockType engineLock (vocoderEngineLock);
+        
+        if (engineLock.isLocked() && vocoderEngine != nullptr)
+        {
+            vocoderEngine->reset();
+            vocoderActive = false;
+        }
     }
     
     // NOW process reverb AFTER noise has been added to the main buffer
     // This ensures reverb processes the vocoded noise with proper release
-    juce::AudioBuffer<float> reverbBuffer (buffer.getNumChannels(), buffer.getNumSamples());
-    
-    // Copy current buffer (including noise) to reverb buffer for processing
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-        reverbBuffer.copyFrom(ch, 0, buffer, ch, 0, buffer.getNumSamples());
+    // The reverb reads the main buffer directly and adds its wet signal,
+    // already scaled by the final wet level, into the send buffer which is
+    // mixed back in at the end of the chain
+    float reverbWetLevel = buildUpNorm * reverbMixNorm;
+    auto& reverbBuffer = scratchBuffers.get (ScratchBuffers::reverbSend, numChannels, numSamples);
     
-    // Process reverb only if reverb mix > 0
+    // Process reverb only if reverb mix > 0 (it's only mixed in below when
+    // the wet level is above 0.001, which implies this)
     if (reverbMixNorm > 0.001f)
     {
-        juce::dsp::AudioBlock<float> reverbBlock (reverbBuffer);
-        juce::dsp::ProcessContextReplacing<float> reverbContext (reverbBlock);
-        freeverb.process (reverbBuffer);
-    }
-    else
-    {
-        // No reverb, clear the buffer
         reverbBuffer.clear();
+        freeverb.processSend (buffer, reverbBuffer, reverbWetLevel);
     }
     
     // Add riser effect with intelligent envelope
@@ -577,123 +734,67 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
         // Exponential curve for more natural buildup feeling
         float buildUpCurve = buildUpNorm * buildUpNorm * buildUpNorm; // Cubic for dramatic effect
         
-        // Add subtle vibrato for organic feel
-        float vibratoRate = 4.0f + buildUpNorm * 2.0f; // Faster vibrato as it builds
-        float vibratoDepth = 0.02f + buildUpNorm * 0.05f; // Deeper vibrato as it builds  
-        float vibrato = std::sin(2.0f * juce::MathConstants<float>::pi * vibratoRate * riserPhase / spec.sampleRate) * vibratoDepth;
-        
         switch (riserType)
         {
             case 0: // Sine riser - smooth and musical
             {
                 float targetFreq = baseFreq + buildUpCurve * (maxFreq - baseFreq);
-                targetFreq *= (1.0f + vibrato); // Add vibrato modulation
                 
-                // Smooth frequency response to prevent artifacts
+                // Smooth frequency response to prevent artifacts; the
+                // oscillator sweeps from the old value to the new one
+                const float startFreq = riserFreq;
                 riserFreq += (targetFreq - riserFreq) * 0.001f; // Much smoother
-                
-                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-                {
-                    auto* data = buffer.getWritePointer (channel);
-                    
-                    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-                    {
-                        float riserSample = std::sin(2.0f * juce::MathConstants<float>::pi * riserPhase) * riserLevel;
-                        data[sample] += riserSample;
-                        
-                        // Use normalized phase increment
-                        float phaseIncrement = riserFreq / spec.sampleRate;
-                        riserPhase += phaseIncrement;
-                        while (riserPhase >= 1.0f)
-                            riserPhase -= 1.0f;
-                    }
-                }
+                addRiserVoice (buffer, RiserOscillatorBank::sine, startFreq, riserFreq, riserLevel);
                 break;
             }
             
             case 1: // Saw riser - aggressive and cutting
             {
                 float targetFreq = baseFreq + buildUpCurve * (maxFreq - baseFreq) * 1.2f; // Slightly higher for aggression
-                targetFreq *= (1.0f + vibrato * 0.5f); // Less vibrato for cleaner aggressive sound
                 
                 // Smooth frequency response to prevent artifacts
+                const float startFreq = smoothSawFreq;
                 smoothSawFreq += (targetFreq - smoothSawFreq) * 0.001f;
-                
-                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-                {
-                    auto* data = buffer.getWritePointer (channel);
-                    
-                    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-                    {
-                        // Generate saw wave
-                        float sawSample = (2.0f * sawPhase - 1.0f) * riserLevel;
-                        data[sample] += sawSample;
-                        
-                        sawPhase += smoothSawFreq / spec.sampleRate;
-                        if (sawPhase >= 1.0f)
-                            sawPhase -= 1.0f;
-                    }
-                }
+                addRiserVoice (buffer, RiserOscillatorBank::saw, startFreq, smoothSawFreq, riserLevel);
                 break;
             }
             
             case 2: // Square riser - digital and punchy
             {
                 float targetFreq = baseFreq + buildUpCurve * (maxFreq - baseFreq) * 0.8f; // Lower max for punchiness
-                targetFreq *= (1.0f + vibrato * 0.3f); // Subtle vibrato
                 
                 // Smooth frequency response to prevent artifacts
+                const float startFreq = smoothSquareFreq;
                 smoothSquareFreq += (targetFreq - smoothSquareFreq) * 0.001f;
-                
-                // Use member phase for square wave
-                
-                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-                {
-                    auto* data = buffer.getWritePointer (channel);
-                    
-                    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-                    {
-                        float squareSample = (std::sin(2.0f * juce::MathConstants<float>::pi * squarePhase) > 0.0f ? 1.0f : -1.0f) * riserLevel * 0.7f;
-                        data[sample] += squareSample;
-                        
-                        // Use normalized phase increment
-                        float phaseIncrement = smoothSquareFreq / spec.sampleRate;
-                        squarePhase += phaseIncrement;
-                        while (squarePhase >= 1.0f)
-                            squarePhase -= 1.0f;
-                    }
-                }
+                addRiserVoice (buffer, RiserOscillatorBank::square, startFreq, smoothSquareFreq, riserLevel * 0.7f);
                 break;
             }
             
             case 3: // Noise sweep
             {
                 // Bandpass filter frequency controlled by buildup
-                float filterFreq = 100.0f + buildUpNorm * buildUpNorm * 8000.0f;
-                noiseFilter.setCutoffFrequency(filterFreq);
-                noiseFilter.setResonance(2.0f + buildUpNorm * 3.0f); // Higher resonance as it builds
-                
-                // Generate filtered noise
-                juce::AudioBuffer<float> noiseBuffer(buffer.getNumChannels(), buffer.getNumSamples());
-                
-                for (int channel = 0; channel < noiseBuffer.getNumChannels(); ++channel)
+                // (retuned only when build up moves)
+                if (buildUpNorm != noiseFilterBuildUp)
                 {
-                    auto* noiseData = noiseBuffer.getWritePointer(channel);
-                    for (int sample = 0; sample < noiseBuffer.getNumSamples(); ++sample)
-                    {
-                        noiseData[sample] = (random.nextFloat() * 2.0f - 1.0f) * riserLevel * 2.0f;
-                    }
+                    noiseFilterBuildUp = buildUpNorm;
+                    float filterFreq = 100.0f + buildUpNorm * buildUpNorm * 8000.0f;
+                    noiseFilter.setCutoffFrequency(filterFreq);
+                    noiseFilter.setResonance(2.0f + buildUpNorm * 3.0f); // Higher resonance as it builds
                 }
                 
-                // Apply filter to noise
+                // Generate and filter one channel of noise
+                auto& noiseBuffer = scratchBuffers.get (ScratchBuffers::riserNoise, 1, numSamples);
+                noiseEngine.fill(0, noiseBuffer.getWritePointer(0), numSamples);
+                
                 juce::dsp::AudioBlock<float> noiseBlock(noiseBuffer);
                 juce::dsp::ProcessContextReplacing<float> noiseContext(noiseBlock);
                 noiseFilter.process(noiseContext);
                 
-                // Add to reverb buffer
+                // Add it to every channel
                 for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
                 {
-                    buffer.addFrom(channel, 0, noiseBuffer, channel, 0, buffer.getNumSamples());
+                    juce::FloatVectorOperations::addWithMultiply(buffer.getWritePointer(channel), noiseBuffer.getReadPointer(0),
+                                                                 riserLevel * 2.0f, numSamples);
                 }
                 break;
             }
@@ -703,29 +804,11 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                 // Start high and go low with exponential curve
                 float reverseDropCurve = (1.0f - buildUpNorm) * (1.0f - buildUpNorm); // Exponential decay
                 float targetFreq = 30.0f + reverseDropCurve * (maxFreq * 0.5f - 30.0f);
-                targetFreq *= (1.0f + vibrato * 0.2f); // Minimal vibrato for sub frequencies
                 
                 // Smooth frequency changes for sub
+                const float startFreq = smoothSubFreq;
                 smoothSubFreq += (targetFreq - smoothSubFreq) * 0.001f;
-                
-                // Use member phase for sub drop
-                
-                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-                {
-                    auto* data = buffer.getWritePointer (channel);
-                    
-                    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-                    {
-                        float subSample = std::sin(2.0f * juce::MathConstants<float>::pi * subPhase) * riserLevel * 1.5f;
-                        data[sample] += subSample;
-                        
-                        // Use normalized phase increment
-                        float phaseIncrement = smoothSubFreq / spec.sampleRate;
-                        subPhase += phaseIncrement;
-                        while (subPhase >= 1.0f)
-                            subPhase -= 1.0f;
-                    }
-                }
+                addRiserVoice (buffer, RiserOscillatorBank::sub, startFreq, smoothSubFreq, riserLevel * 1.5f);
                 break;
             }
         }
@@ -736,32 +819,71 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
         // This prevents clicks and artifacts
     }
     
+    // Host tempo and position, for the tremolo sync and the delay
+    bool hostPlaying = false;
+    double hostPpqPosition = 0.0;
+    
+    if (auto* playHead = getPlayHead())
+    {
+        juce::AudioPlayHead::CurrentPositionInfo positionInfo;
+        if (playHead->getCurrentPosition(positionInfo))
+        {
+            if (positionInfo.bpm > 0)
+                currentBPM = (float)positionInfo.bpm;
+            
+            hostPlaying = positionInfo.isPlaying;
+            hostPpqPosition = positionInfo.ppqPosition;
+        }
+    }
+    
+    // Tremolo and smart pan share one LFO. Synced, one cycle lasts the
+    // chosen note (1/1 = 4 beats) and the phase follows the host's beat
+    // position while it plays.
+    if (tremoloSync > 0)
+    {
+        const double beatsPerCycle = 4.0 / (double) (1 << (tremoloSync - 1));
+        tremoloLfo.setFrequency ((float) (currentBPM / 60.0 / beatsPerCycle));
+        
+        if (hostPlaying)
+            tremoloLfo.syncToBeat (hostPpqPosition, beatsPerCycle);
+    }
+    else
+    {
+        tremoloLfo.setFrequency (tremoloRate);
+    }
+    
+    const bool tremoloActive = tremoloDepth / 100.0f > 0.01f;
+    const bool panActive = smartPan > 0.01f && buffer.getNumChannels() >= 2;
+    const float* lfo = nullptr;
+    
+    if (tremoloActive || panActive)
+    {
+        auto* lfoData = scratchBuffers.get (ScratchBuffers::modulation, 1, numSamples).getWritePointer (0);
+        tremoloLfo.render (lfoData, numSamples);
+        lfo = lfoData;
+    }
+    else
+    {
+        // Let the LFO run on so it doesn't restart when switched back on
+        tremoloLfo.advance (numSamples);
+    }
+    
     // Apply tremolo to main signal (now works without reverb)
-    if (tremoloDepth / 100.0f > 0.01f)
+    if (tremoloActive)
     {
+        // gain = 1 - depth/2 (1 + lfo)
         float tremDepth = (tremoloDepth / 100.0f);
-        float phaseIncrement = tremoloRate * 2.0f * juce::MathConstants<float>::pi / spec.sampleRate;
+        const float gainOffset = 1.0f - tremDepth * 0.5f;
+        const float gainScale = -tremDepth * 0.5f;
         
         for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
         {
             auto* data = buffer.getWritePointer (channel);
             
-            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-            {
-                float tremolo = 1.0f - (tremDepth * 0.5f * (1.0f + std::sin(tremoloPhase)));
-                data[sample] *= tremolo;
-                
-                tremoloPhase += phaseIncrement;
-                if (tremoloPhase > 2.0f * juce::MathConstants<float>::pi)
-                    tremoloPhase -= 2.0f * juce::MathConstants<float>::pi;
-            }
+            for (int sample = 0; sample < numSamples; ++sample)
+                data[sample] *= gainOffset + gainScale * lfo[sample];
         }
     }
-    else
-    {
-        // Let tremolo phase continue to prevent clicks
-        // It will naturally fade with the amplitude
-    }
     
     // Apply stereo width processing to main signal  
     if (buffer.getNumChannels() >= 2 && std::abs(stereoWidth - 100.0f) > 0.1f)
@@ -783,48 +905,25 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     }
     
     // Apply smart panning linked to tremolo
-    if (smartPan > 0.01f && buffer.getNumChannels() >= 2)
+    if (panActive)
     {
         float panDepth = (smartPan / 100.0f);
         
-        // Use the same tremolo phase but offset for right channel
-        float panPhaseL = tremoloPhase;
-        float panPhaseR = tremoloPhase + juce::MathConstants<float>::pi; // 180 degrees out of phase
+        // Apply panning. The left pan position follows the LFO and the right
+        // runs 180 degrees behind, at 1 - panL: left gets panL of itself plus
+        // half of (1 - panL) of the right, and the right the mirror image.
+        auto* left = buffer.getWritePointer (0);
+        auto* right = buffer.getWritePointer (1);
         
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        for (int sample = 0; sample < numSamples; ++sample)
         {
-            float left = buffer.getSample(0, sample);
-            float right = buffer.getSample(1, sample);
-            
-            // Calculate pan positions using sin wave (same as tremolo)
-            float panL = 0.5f + 0.5f * std::sin(panPhaseL) * panDepth;
-            float panR = 0.5f + 0.5f * std::sin(panPhaseR) * panDepth;
-            
-            // Apply panning
-            buffer.setSample(0, sample, left * (1.0f - panR) + right * (1.0f - panL) * 0.5f);
-            buffer.setSample(1, sample, right * (1.0f - panL) + left * (1.0f - panR) * 0.5f);
+            const float l = left[sample];
+            const float r = right[sample];
+            const float panL = 0.5f + 0.5f * panDepth * lfo[sample];
+            const float panR = 1.0f - panL;
             
-            // Update phase (using tremolo rate)
-            float phaseIncrement = tremoloRate * 2.0f * juce::MathConstants<float>::pi / spec.sampleRate;
-            panPhaseL += phaseIncrement;
-            panPhaseR += phaseIncrement;
-            
-            // Wrap phases
-            if (panPhaseL > 2.0f * juce::MathConstants<float>::pi)
-                panPhaseL -= 2.0f * juce::MathConstants<float>::pi;
-            if (panPhaseR > 2.0f * juce::MathConstants<float>::pi)
-                panPhaseR -= 2.0f * juce::MathConstants<float>::pi;
-        }
-    }
-    
-    // Always update delay tempo and parameters
-    if (auto* playHead = getPlayHead())
-    {
-        juce::AudioPlayHead::CurrentPositionInfo positionInfo;
-        if (playHead->getCurrentPosition(positionInfo))
-        {
-            if (positionInfo.bpm > 0)
-                currentBPM = (float)positionInfo.bpm;
+            left[sample] = l * panL + r * panR * 0.5f;
+            right[sample] = r * panR + l * panL * 0.5f;
         }
     }
     
@@ -842,62 +941,56 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     }
     
     float delayInSeconds = delayInBeats / beatsPerSecond;
-    delaySampleLength = (int)(delayInSeconds * spec.sampleRate);
     
     // Always process delay buffer to keep it in sync
     float delayMixNorm = (delayMix / 100.0f);
     float feedbackNorm = delayFeedback / 100.0f;
     
-    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+    // Tail length: the reverb's T60 when it's in the mix, and the time for
+    // the delay's repeats to fall 60dB (each one is feedbackNorm * 0.95 of
+    // the last). The sleep check uses the same figures taken down to -90dB.
     {
-        // Get delayed samples
-        int readPos = delayWritePos - delaySampleLength;
-        if (readPos < 0)
-            readPos += delayBufferL.getNumSamples();
-        
-        float delayedL = delayBufferL.getSample(0, readPos);
-        float delayedR = delayBufferR.getSample(0, readPos);
-        
-        // Get current samples from main buffer
-        float currentL = buffer.getSample(0, sample);
-        float currentR = buffer.getSample(1, sample);
-        
-        // Only apply feedback if delay is active
-        if (delayMix > 0.01f)
+        auto tailFor = [&] (double decayDb)
         {
-            // Write to delay buffer with feedback (with safety limiting)
-            float writeL = currentL + delayedL * feedbackNorm * 0.95f;
-            float writeR = currentR + delayedR * feedbackNorm * 0.95f;
+            double tail = 0.0;
             
-            // Soft clip to prevent overload
-            writeL = std::tanh(writeL);
-            writeR = std::tanh(writeR);
+            if (reverbMixNorm > 0.001f)
+                tail = freeverb.getTailLengthSeconds (decayDb);
             
-            delayBufferL.setSample(0, delayWritePos, writeL);
-            delayBufferR.setSample(0, delayWritePos, writeR);
+            if (delayMix > 0.01f)
+            {
+                const double repeatGain = feedbackNorm * 0.95;
+                const double repeats = repeatGain > 0.0 ? decayDb / (-20.0 * std::log10 (repeatGain)) : 0.0;
+                tail = juce::jmax (tail, delayInSeconds * (1.0 + repeats));
+            }
             
-            // Mix delayed signal with current in main buffer
-            buffer.setSample(0, sample, currentL + delayedL * delayMixNorm);
-            buffer.setSample(1, sample, currentR + delayedR * delayMixNorm);
-        }
-        else
+            return tail;
+        };
+        
+        const double tail = tailFor (60.0);
+        tailLengthSeconds.store (tail);
+        sleepTailSeconds = juce::jmax (tailFor (90.0), vocoderReleaseSeconds);
+        
+        // Hosts only query the tail again when told it changed; tell them
+        // from the message thread once it has moved by more than 10%
+        if (std::abs (tail - postedTailSeconds) > 0.1 * juce::jmax (tail, postedTailSeconds))
         {
-            // When mix is 0, just write dry signal to clear buffer
-            delayBufferL.setSample(0, delayWritePos, currentL * 0.0f);
-            delayBufferR.setSample(0, delayWritePos, currentR * 0.0f);
-            
-            // No mixing - output is unchanged
+            postedTailSeconds = tail;
+            triggerAsyncUpdate();
         }
-        
-        // Always increment write position to keep buffer moving
-        delayWritePos++;
-        if (delayWritePos >= delayBufferL.getNumSamples())
-            delayWritePos = 0;
     }
     
+    tempoDelay.setDelaySeconds (delayInSeconds);
+    
+    // Only apply feedback if delay is active; otherwise keep the lines
+    // moving and let them fill with silence
+    if (delayMix > 0.01f)
+        tempoDelay.process (buffer, delayMixNorm, feedbackNorm * 0.95f);
+    else
+        tempoDelay.advance (numSamples);
+    
     // Now mix in the reverb based on reverb amount
-    // Calculate reverb wet level based on Build Up intensity AND reverb mix
-    float reverbWetLevel = buildUpNorm * reverbMixNorm;
+    // (reverbWetLevel = Build Up intensity x reverb mix, computed above)
     
     // Apply a subtle gain reduction to compensate for any buildup
     float mixCompensation = 1.0f / (1.0f + reverbWetLevel * 0.2f);
@@ -905,17 +998,12 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     // Only mix in reverb if there's reverb to add
     if (reverbWetLevel > 0.001f)
     {
-        // Mix reverb with the already-processed signal
-        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        // Simple reverb mix - the send is already scaled by the wet level
+        for (int channel = 0; channel < numChannels; ++channel)
         {
             auto* dry = buffer.getWritePointer(channel);
-            auto* wet = reverbBuffer.getReadPointer(channel);
-            
-            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-            {
-                // Simple reverb mix - add wet reverb to processed signal
-                dry[sample] = dry[sample] * (1.0f - reverbWetLevel) + wet[sample] * reverbWetLevel;
-            }
+            juce::FloatVectorOperations::multiply (dry, 1.0f - reverbWetLevel, numSamples);
+            juce::FloatVectorOperations::add (dry, reverbBuffer.getReadPointer(channel), numSamples);
         }
     }
     
@@ -955,51 +1043,79 @@ void BuildUpVerbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     
     // Store previous buildup to detect changes
     previousBuildUp = buildUpNorm;
+    
+    // Go to sleep once every tail has rung out. The reverb and delay lines
+    // are left as they are: they're below -90dB by now, and clearing them
+    // would be a pass over every line on the audio thread.
+    if (silentSamples > sleepTailSeconds * spec.sampleRate
+        && buffer.getMagnitude (0, numSamples) < silenceThreshold)
+        isIdle = true;
 }
 
-void BuildUpVerbAudioProcessor::updateDSPFromParameters()
+void BuildUpVerbAudioProcessor::invalidateControls()
+{
+    filterControls = {};
+    highPassSettings = {};
+    lowPassSettings = {};
+    reverbBuildUp = -1.0f;
+    noiseFilterBuildUp = -1.0f;
+}
+
+void BuildUpVerbAudioProcessor::updateDSPFromParameters (const ParameterSnapshot& snapshot)
 {
-    float buildUp = *parameters.getRawParameterValue ("buildup");
-    float filterIntensity = *parameters.getRawParameterValue ("filterIntensity");
-    float filterResonance = *parameters.getRawParameterValue ("filterResonance");
-    int filterType = (int)*parameters.getRawParameterValue ("filterType");
-    int filterSlope = (int)*parameters.getRawParameterValue ("filterSlope");
-    float buildUpNorm = buildUp / 100.0f;
-    float filterIntensityNorm = filterIntensity / 100.0f;
-    
     // Update Freeverb parameters based on SMOOTHED build up to prevent clicks
     // Freeverb has different parameter ranges than JUCE reverb
-    freeverb.setRoomSize(0.3f + (smoothedBuildUp * 0.65f));      // 0.3 to 0.95 (Freeverb sounds best 0.0-1.0)
-    freeverb.setDamping(0.7f - (smoothedBuildUp * 0.5f));        // 0.7 to 0.2 (less damping = brighter)
-    freeverb.setWetLevel(0.3f + (smoothedBuildUp * 0.5f));       // 0.3 to 0.8 - balanced wet level
-    freeverb.setDryLevel(0.0f);                               // 0% dry - we add dry signal separately
-    freeverb.setWidth(0.5f + (smoothedBuildUp * 0.5f));          // 0.5 to 1.0
-    freeverb.setFreezeMode(0.0f);                            // No freeze
+    if (smoothedBuildUp != reverbBuildUp)
+    {
+        reverbBuildUp = smoothedBuildUp;
+        freeverb.setRoomSize(0.3f + (smoothedBuildUp * 0.65f));      // 0.3 to 0.95 (Freeverb sounds best 0.0-1.0)
+        freeverb.setDamping(0.7f - (smoothedBuildUp * 0.5f));        // 0.7 to 0.2 (less damping = brighter)
+        freeverb.setWetLevel(0.3f + (smoothedBuildUp * 0.5f));       // 0.3 to 0.8 - balanced wet level
+        freeverb.setDryLevel(0.0f);                               // 0% dry - we add dry signal separately
+        freeverb.setWidth(0.5f + (smoothedBuildUp * 0.5f));          // 0.5 to 1.0
+        freeverb.setFreezeMode(0.0f);                            // No freeze
+    }
+    
+    FilterControls controls;
+    controls.buildUp = snapshot.buildUp;
+    controls.intensity = snapshot.filterIntensity;
+    controls.resonance = snapshot.filterResonance;
+    controls.type = snapshot.filterType;
+    controls.slope = snapshot.filterSlope;
+    
+    // Nothing that feeds the filters has moved
+    if (controls == filterControls)
+        return;
+    
+    filterControls = controls;
+    
+    float buildUpNorm = controls.buildUp / 100.0f;
+    float filterIntensityNorm = controls.intensity / 100.0f;
+    float filterResonance = controls.resonance;
+    int filterType = controls.type;
+    int filterSlope = controls.slope;
     
     // Simple linear filter automation for high/low pass, logarithmic only for bandpass
     float filterAmount = buildUpNorm * filterIntensityNorm;
     
-    // Helper lambda to set all filter stages
+    // Helpers to set all filter stages, skipping the tan() prewarp inside
+    // setCutoffFrequency when a cascade's settings haven't changed
     auto setAllHighPassFilters = [&](float freq, float res) {
-        highPassFilter.setCutoffFrequency(freq);
-        highPassFilter.setResonance(res);
-        highPassFilter2.setCutoffFrequency(freq);
-        highPassFilter2.setResonance(0.5f); // Lower resonance on cascaded stages
-        highPassFilter3.setCutoffFrequency(freq);
-        highPassFilter3.setResonance(0.5f);
-        highPassFilter4.setCutoffFrequency(freq);
-        highPassFilter4.setResonance(0.5f);
+        const CutoffSettings settings { freq, res };
+        if (settings == highPassSettings)
+            return;
+        
+        highPassSettings = settings;
+        buildUpFilter.setHighPass(freq, res); // Cascaded stages get lower resonance
     };
     
     auto setAllLowPassFilters = [&](float freq, float res) {
-        lowPassFilter.setCutoffFrequency(freq);
-        lowPassFilter.setResonance(res);
-        lowPassFilter2.setCutoffFrequency(freq);
-        lowPassFilter2.setResonance(0.5f); // Lower resonance on cascaded stages
-        lowPassFilter3.setCutoffFrequency(freq);
-        lowPassFilter3.setResonance(0.5f);
-        lowPassFilter4.setCutoffFrequency(freq);
-        lowPassFilter4.setResonance(0.5f);
+        const CutoffSettings settings { freq, res };
+        if (settings == lowPassSettings)
+            return;
+        
+        lowPassSettings = settings;
+        buildUpFilter.setLowPass(freq, res); // Cascaded stages get lower resonance
     };
     
     // Unity gain bypass when no filtering
@@ -1088,53 +1204,65 @@ void BuildUpVerbAudioProcessor::setStateInformation (const void* data, int sizeI
             parameters.replaceState (juce::ValueTree::fromXml (*xmlState));
 }
 
-void BuildUpVerbAudioProcessor::applyMacroControl(float macroValue, int mode) const
+void BuildUpVerbAudioProcessor::applyMacroModulation (ParameterSnapshot& snapshot, float macroValue, int mode)
 {
+    // Normalised value for each target; negative leaves the parameter as set
+    std::array<float, numMacroTargets> modulation;
+    modulation.fill (-1.0f);
+    
+    // Resonance sweeps are set in plain Q and normalised through the
+    // parameter's own (skewed 0.5-4) range
+    auto resonance = [this] (float start, float end, float amount)
+    {
+        return macroParameters[macroFilterResonance]->convertTo0to1 (start + (end - start) * amount);
+    };
+    
     // Different macro modes control parameters differently
     switch (mode)
     {
         case 1: // Subtle mode
-            if (auto* param = parameters.getParameter("filterIntensity"))
-                param->setValueNotifyingHost(macroValue * 0.7f);
-            if (auto* param = parameters.getParameter("reverbMix"))
-                param->setValueNotifyingHost(macroValue * 0.5f);
-            if (auto* param = parameters.getParameter("stereoWidth"))
-                param->setValueNotifyingHost(0.5f + macroValue * 0.5f); // 50-100%
+            modulation[macroFilterIntensity] = macroValue * 0.7f;
+            modulation[macroReverbMix] = macroValue * 0.5f;
+            modulation[macroStereoWidth] = 0.5f + macroValue * 0.5f; // 50-100%
             break;
             
         case 2: // Aggressive mode
-            if (auto* param = parameters.getParameter("filterIntensity"))
-                param->setValueNotifyingHost(macroValue);
-            if (auto* param = parameters.getParameter("reverbMix"))
-                param->setValueNotifyingHost(macroValue * 0.8f);
-            if (auto* param = parameters.getParameter("noiseAmount"))
-                param->setValueNotifyingHost(macroValue * macroValue * 0.5f); // Exponential
-            if (auto* param = parameters.getParameter("filterResonance"))
-                param->setValueNotifyingHost((3.0f - 0.5f) / (10.0f - 0.5f) + macroValue * 0.6f); // Map to normalized range
-            if (auto* param = parameters.getParameter("stereoWidth"))
-                param->setValueNotifyingHost(1.0f - macroValue * 0.7f); // 100% down to 30%
+            modulation[macroFilterIntensity] = macroValue;
+            modulation[macroReverbMix] = macroValue * 0.8f;
+            modulation[macroNoiseAmount] = macroValue * macroValue * 0.5f; // Exponential
+            modulation[macroFilterResonance] = resonance (3.0f, 4.0f, macroValue); // Up to the maximum
+            modulation[macroStereoWidth] = 1.0f - macroValue * 0.7f; // 100% down to 30%
             break;
             
         case 3: // Epic mode
-            if (auto* param = parameters.getParameter("filterIntensity"))
-                param->setValueNotifyingHost(macroValue);
-            if (auto* param = parameters.getParameter("reverbMix"))
-                param->setValueNotifyingHost(macroValue);
-            if (auto* param = parameters.getParameter("noiseAmount"))
-                param->setValueNotifyingHost(macroValue * 0.7f);
-            if (auto* param = parameters.getParameter("riserAmount"))
-                param->setValueNotifyingHost(macroValue * macroValue); // Exponential riser
-            if (auto* param = parameters.getParameter("tremoloDepth"))
-                param->setValueNotifyingHost(macroValue * 0.6f);
-            if (auto* param = parameters.getParameter("filterResonance"))
-                param->setValueNotifyingHost((2.0f - 0.5f) / (10.0f - 0.5f) + macroValue * 0.8f); // Map to normalized range
-            if (auto* param = parameters.getParameter("stereoWidth"))
-                param->setValueNotifyingHost(1.0f - macroValue * 0.5f + macroValue * macroValue * 1.0f); // U-shape: 100% -> 50% -> 150%
+            modulation[macroFilterIntensity] = macroValue;
+            modulation[macroReverbMix] = macroValue;
+            modulation[macroNoiseAmount] = macroValue * 0.7f;
+            modulation[macroRiserAmount] = macroValue * macroValue; // Exponential riser
+            modulation[macroTremoloDepth] = macroValue * 0.6f;
+            modulation[macroFilterResonance] = resonance (2.0f, 3.8f, macroValue);
+            modulation[macroStereoWidth] = 1.0f - macroValue * 0.5f + macroValue * macroValue * 1.0f; // U-shape: 100% -> 50% -> 150%
             break;
             
         case 4: // Custom mode - user controls everything manually
             break;
     }
+    
+    float* targets[numMacroTargets] = { &snapshot.filterIntensity, &snapshot.reverbMix, &snapshot.noiseAmount,
+                                        &snapshot.filterResonance, &snapshot.stereoWidth, &snapshot.riserAmount,
+                                        &snapshot.tremoloDepth };
+    
+    for (size_t i = 0; i < modulation.size(); ++i)
+    {
+        // Clamped the way the host clamps a normalised value, then mapped
+        // through the parameter's own range
+        const float normalised = modulation[i] < 0.0f ? -1.0f : juce::jlimit (0.0f, 1.0f, modulation[i]);
+        
+        if (normalised >= 0.0f)
+            *targets[i] = macroParameters[i]->convertFrom0to1 (normalised);
+        
+        macroModulation[i].store (normalised, std::memory_order_relaxed);
+    }
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -3,10 +3,20 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include "FreeverbWrapper.h"
-#include <complex>
+#include "FilterCascade.h"
+#include "DriveStage.h"
+#include "RiserOscillatorBank.h"
+#include "ModulationLfo.h"
+#include "TempoDelay.h"
+#include "ScratchBuffers.h"
+#include "NoiseEngine.h"
+#include "VocoderEngine.h"
 #include <array>
+#include <atomic>
+#include <memory>
 
-class BuildUpVerbAudioProcessor : public juce::AudioProcessor
+class BuildUpVerbAudioProcessor : public juce::AudioProcessor,
+                                  private juce::AsyncUpdater
 {
 public:
     BuildUpVerbAudioProcessor();
@@ -60,47 +70,114 @@ public:
 
     juce::AudioProcessorValueTreeState parameters;
     
-    // Vocoder processing
-    void processVocoder(juce::AudioBuffer<float>& buffer, 
-                       juce::AudioBuffer<float>& noiseBuffer,
-                       float vocoderGain,
-                       float vocoderRelease,
-                       float vocoderBrightness = 0.5f);
-                       
-    // Alternative filterbank vocoder
-    void processVocoderFilterbank(juce::AudioBuffer<float>& buffer, 
-                                 juce::AudioBuffer<float>& noiseBuffer,
-                                 float vocoderGain,
-                                 float vocoderRelease,
-                                 float vocoderBrightness = 0.5f);
-                                 
-    // Simple vocoder for debugging
-    void processVocoderSimple(juce::AudioBuffer<float>& buffer, 
-                             juce::AudioBuffer<float>& noiseBuffer,
-                             float vocoderGain,
-                             float vocoderRelease,
-                             float vocoderBrightness = 0.5f);
-                             
-    // Gate-based vocoder (no envelope following)
-    void processVocoderGated(juce::AudioBuffer<float>& buffer, 
-                            juce::AudioBuffer<float>& noiseBuffer,
-                            float vocoderGain,
-                            float vocoderRelease,
-                            float vocoderBrightness = 0.5f);
+    // Parameters the macro modes drive. The macro is a modulation layer: it
+    // changes the values the DSP uses, never the host's parameters.
+    enum MacroTarget
+    {
+        macroFilterIntensity,
+        macroReverbMix,
+        macroNoiseAmount,
+        macroFilterResonance,
+        macroStereoWidth,
+        macroRiserAmount,
+        macroTremoloDepth,
+        numMacroTargets
+    };
+    
+    // The normalised value the macro layer last gave a target, or -1 if the
+    // current mode leaves it alone. Lock-free, for the editor to poll.
+    float getMacroModulation (MacroTarget target) const { return macroModulation[(size_t) target].load (std::memory_order_relaxed); }
     
 private:
+    // Every parameter's value for one block. processBlock fills it once at
+    // the top and hands it to each stage, so the stages agree on one set of
+    // values and nothing looks parameters up by name on the audio thread.
+    struct ParameterSnapshot
+    {
+        float buildUp = 0.0f;
+        float filterIntensity = 0.0f;
+        float filterResonance = 0.0f;
+        int filterType = 0;
+        int filterSlope = 0;
+        float filterDrive = 0.0f;
+        int driveOversampling = 0;
+        float reverbMix = 0.0f;
+        float noiseAmount = 0.0f;
+        float vocoderRelease = 0.0f;
+        float vocoderBrightness = 0.0f;
+        int vocoderBands = 0;
+        int vocoderAnalysisRate = 0;
+        float tremoloRate = 0.0f;
+        float tremoloDepth = 0.0f;
+        int tremoloSync = 0;
+        float riserAmount = 0.0f;
+        int riserType = 0;
+        float riserRelease = 0.0f;
+        float stereoWidth = 0.0f;
+        float smartPan = 0.0f;
+        float noiseGate = 0.0f;
+        bool autoGain = false;
+        int macroMode = 0;
+        float delayMix = 0.0f;
+        int delayTime = 0;
+        float delayFeedback = 0.0f;
+    };
+    
+    // The value tree's atomics, resolved by ID once in the constructor
+    struct ParameterHandles
+    {
+        std::atomic<float>* buildUp = nullptr;
+        std::atomic<float>* filterIntensity = nullptr;
+        std::atomic<float>* filterResonance = nullptr;
+        std::atomic<float>* filterType = nullptr;
+        std::atomic<float>* filterSlope = nullptr;
+        std::atomic<float>* filterDrive = nullptr;
+        std::atomic<float>* driveOversampling = nullptr;
+        std::atomic<float>* reverbMix = nullptr;
+        std::atomic<float>* noiseAmount = nullptr;
+        std::atomic<float>* vocoderRelease = nullptr;
+        std::atomic<float>* vocoderBrightness = nullptr;
+        std::atomic<float>* vocoderBands = nullptr;
+        std::atomic<float>* vocoderAnalysisRate = nullptr;
+        std::atomic<float>* vocoderEngine = nullptr;
+        std::atomic<float>* tremoloRate = nullptr;
+        std::atomic<float>* tremoloDepth = nullptr;
+        std::atomic<float>* tremoloSync = nullptr;
+        std::atomic<float>* riserAmount = nullptr;
+        std::atomic<float>* riserType = nullptr;
+        std::atomic<float>* riserRelease = nullptr;
+        std::atomic<float>* stereoWidth = nullptr;
+        std::atomic<float>* smartPan = nullptr;
+        std::atomic<float>* noiseGate = nullptr;
+        std::atomic<float>* autoGain = nullptr;
+        std::atomic<float>* macroMode = nullptr;
+        std::atomic<float>* delayMix = nullptr;
+        std::atomic<float>* delayTime = nullptr;
+        std::atomic<float>* delayFeedback = nullptr;
+    };
+    
+    ParameterHandles parameterHandles;
+    
+    // Each macro target's parameter, for its range, and its published value
+    std::array<juce::RangedAudioParameter*, numMacroTargets> macroParameters {};
+    std::array<std::atomic<float>, numMacroTargets> macroModulation;
+    
+    ParameterSnapshot loadParameters() const;
+    
     FreeverbWrapper freeverb;
-    juce::dsp::StateVariableTPTFilter<float> highPassFilter;
-    juce::dsp::StateVariableTPTFilter<float> lowPassFilter; // For dual-filter automation
-    // Additional filter stages for steeper slopes (6dB = 1 stage, 12dB = 2, 18dB = 3, 24dB = 4)
-    juce::dsp::StateVariableTPTFilter<float> highPassFilter2;
-    juce::dsp::StateVariableTPTFilter<float> highPassFilter3;
-    juce::dsp::StateVariableTPTFilter<float> highPassFilter4;
-    juce::dsp::StateVariableTPTFilter<float> lowPassFilter2;
-    juce::dsp::StateVariableTPTFilter<float> lowPassFilter3;
-    juce::dsp::StateVariableTPTFilter<float> lowPassFilter4;
+    // High and low pass cascades for the filter sweep, one stage per 6dB of
+    // slope (6dB = 1 stage ... 48dB = 8)
+    FilterCascade buildUpFilter;
+    
+    // Oversampled saturation in front of the filter
+    DriveStage driveStage;
     juce::dsp::ProcessSpec spec;
-    juce::Random random;
+    
+    // White noise for the vocoders and the Noise Sweep riser, one stream per channel
+    NoiseEngine noiseEngine;
+    
+    // Temporary buffers for the chain, sized in prepareToPlay
+    ScratchBuffers scratchBuffers;
     
     float previousBuildUp = 0.0f;
     mutable float smoothedBuildUp = 0.0f;  // Smoothed build up value
@@ -109,45 +186,31 @@ private:
     mutable float smoothedVocoderLevel = 0.0f;  // Extra smoothing for vocoder
     int currentPreset = 0;
     
-    // Tremolo
-    mutable float tremoloPhase = 0.0f;
+    // Tremolo and smart pan, free-running or locked to the host's beat
+    ModulationLfo tremoloLfo;
     
     // Riser
+    RiserOscillatorBank riserOscillators;
     mutable float riserFreq = 100.0f;
-    mutable float riserPhase = 0.0f;
-    mutable float sawPhase = 0.0f;
-    mutable float squarePhase = 0.0f;
-    mutable float subPhase = 0.0f;
     mutable float smoothSubFreq = 30.0f;
     mutable float currentRiserLevel = 0.0f;
     mutable float smoothSawFreq = 100.0f;
     mutable float smoothSquareFreq = 100.0f;
     juce::dsp::StateVariableTPTFilter<float> noiseFilter;
+    float noiseFilterBuildUp = -1.0f;  // Build up the noise filter was last tuned for
     float lastBuildUp = 0.0f;
     
-    // FFT for vocoder
-    static constexpr int fftOrder = 10; // 1024 samples
-    static constexpr int fftSize = 1 << fftOrder;
-    static constexpr int numBands = 4; // 4 bands like Ableton
-    
-    juce::dsp::FFT forwardFFT;
-    std::vector<float> fftData;
-    std::vector<float> window;
-    std::vector<std::complex<float>> frequencyData;
-    std::vector<float> magnitudes;
-    std::vector<float> phases;
-    std::vector<float> bandLevels;
-    std::vector<float> smoothedBandLevels;
-    int fftPos = 0;
-    int hopSize = fftSize / 4; // 75% overlap for smoother output
-    int hopCounter = 0;
-    std::vector<float> overlapBuffer;
-    std::vector<float> prevPhases;
-    std::vector<float> inputBuffer;  // Circular buffer for input
-    std::vector<float> outputBuffer; // Circular buffer for output
-    std::array<int, 2> inputWritePos = {0, 0};  // Per-channel positions
-    std::array<int, 2> outputReadPos = {0, 0};  // Per-channel positions  
-    std::array<int, 2> channelHopCounter = {0, 0}; // Per-channel hop counter
+    // The vocoder the "vocoderEngine" parameter selects; the others aren't
+    // instantiated. A new selection is built and prepared on the message
+    // thread and swapped in under the lock, which processBlock only try-locks,
+    // so the audio thread never waits or allocates. Engines add no reported
+    // latency: their output is mixed in as it comes.
+    std::unique_ptr<VocoderEngine> vocoderEngine;
+    std::atomic<VocoderEngine::Type> vocoderEngineType { VocoderEngine::Type::filterbank };
+    juce::SpinLock vocoderEngineLock;
+    double preparedSampleRate = 0.0;
+    int preparedNumChannels = 0;
+    bool vocoderActive = false;
     
     // Stereo width
     float widthDelayL = 0.0f;
@@ -160,24 +223,80 @@ private:
     // Auto gain
     mutable float currentGainReduction = 1.0f;
     
-    // Macro control
-    mutable float lastMacroValue = -1.0f;
-    
     // Envelope follower for intelligent noise gating
     mutable float envelopeLevel = 0.0f;
     mutable float noiseGateThreshold = 0.001f; // -60dB threshold
+    float smoothEnvelopeGate = 0.0f;
     
     // Delay processing
-    juce::AudioBuffer<float> delayBufferL, delayBufferR;
-    int delayWritePos = 0;
+    TempoDelay tempoDelay;
     float currentBPM = 120.0f;
-    int delaySampleLength = 0;
     
-    juce::AudioBuffer<float> fftInputBuffer;
-    juce::AudioBuffer<float> fftOutputBuffer;
+    // Tail reporting and idle sleep. The tail is recomputed on the audio
+    // thread from the reverb and delay settings and read by the host, which
+    // handleAsyncUpdate tells when it has changed.
+    std::atomic<double> tailLengthSeconds { 5.0 };
+    double postedTailSeconds = 5.0;     // Audio thread: last tail an update was posted for
+    double hostTailSeconds = 5.0;       // Message thread: last tail the host was told about
+    static constexpr float silenceThreshold = 3.16e-5f; // -90dB
+    static constexpr double vocoderReleaseSeconds = 1.0;
+    double sleepTailSeconds = 5.0;
+    int silentSamples = 0;
+    bool isIdle = false;
+    
+    
+    // Control-rate change detection. updateDSPFromParameters runs every
+    // block but only recomputes coefficients whose inputs moved since the
+    // last block: the reverb follows smoothedBuildUp, and each filter
+    // cascade follows the cutoff and resonance derived from these inputs.
+    struct FilterControls
+    {
+        float buildUp = -1.0f;
+        float intensity = -1.0f;
+        float resonance = -1.0f;
+        int type = -1;
+        int slope = -1;
+        
+        bool operator== (const FilterControls& other) const
+        {
+            return buildUp == other.buildUp && intensity == other.intensity
+                && resonance == other.resonance && type == other.type && slope == other.slope;
+        }
+    };
+    
+    struct CutoffSettings
+    {
+        float frequency = -1.0f;
+        float resonance = -1.0f;
+        
+        bool operator== (const CutoffSettings& other) const
+        {
+            return frequency == other.frequency && resonance == other.resonance;
+        }
+    };
+    
+    FilterControls filterControls;
+    CutoffSettings highPassSettings, lowPassSettings;
+    float reverbBuildUp = -1.0f;
+    
+    // Forces the next updateDSPFromParameters to recompute everything
+    void invalidateControls();
+    
+    VocoderEngine::Type getSelectedVocoderEngine() const;
+    void rebuildVocoderEngine();
+    void handleAsyncUpdate() override;
+    
+    // Reports the drive stage's latency for the selected oversampling;
+    // message thread or prepareToPlay only
+    void updateLatency();
+    
+    // Renders a riser voice sweeping from startFreq to endFreq and adds it
+    // to every channel of buffer at gain
+    void addRiserVoice (juce::AudioBuffer<float>& buffer, RiserOscillatorBank::Voice voice,
+                        float startFreq, float endFreq, float gain);
     
-    void updateDSPFromParameters();
-    void applyMacroControl(float macroValue, int mode) const;
+    void updateDSPFromParameters (const ParameterSnapshot& snapshot);
+    void applyMacroModulation (ParameterSnapshot& snapshot, float macroValue, int mode);
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BuildUpVerbAudioProcessor)
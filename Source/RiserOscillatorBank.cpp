@@ -0,0 +1,123 @@
+#include "RiserOscillatorBank.h"
+#include <cmath>
+
+void RiserOscillatorBank::prepare(double newSampleRate)
+{
+    if (newSampleRate != sampleRate || sineTable.empty())
+    {
+        sampleRate = newSampleRate;
+        buildTables();
+    }
+    
+    reset();
+}
+
+void RiserOscillatorBank::reset()
+{
+    for (auto& phase : phases)
+        phase = 0.0f;
+}
+
+void RiserOscillatorBank::buildTables()
+{
+    constexpr auto tableStride = (size_t) tableSize + 1;
+    const double twoPi = juce::MathConstants<double>::twoPi;
+    
+    sineTable.resize(tableStride);
+    
+    for (int i = 0; i < tableSize; ++i)
+        sineTable[(size_t) i] = (float) std::sin(twoPi * i / tableSize);
+    
+    sineTable[tableSize] = sineTable[0];
+    
+    // One level per octave until only the fundamental fits
+    const double nyquist = sampleRate * 0.5;
+    numLevels = juce::jmax(1, (int) std::ceil(std::log2(nyquist / baseFrequency)) + 1);
+    sawTables.assign((size_t) numLevels * tableStride, 0.0f);
+    squareTables.assign((size_t) numLevels * tableStride, 0.0f);
+    
+    for (int level = 0; level < numLevels; ++level)
+    {
+        const double topFrequency = baseFrequency * std::exp2((double) level);
+        const int numHarmonics = juce::jlimit(1, tableSize / 2 - 1, (int) (nyquist / topFrequency));
+        
+        float* sawTable = sawTables.data() + (size_t) level * tableStride;
+        float* squareTable = squareTables.data() + (size_t) level * tableStride;
+        
+        // Fourier series of the rising ramp 2p - 1 and of the square that is
+        // +1 for the first half cycle, so the phase matches the naive shapes.
+        // sin(2pi h i / N) is the sine table at (h i) mod N.
+        for (int harmonic = 1; harmonic <= numHarmonics; ++harmonic)
+        {
+            const auto sawGain = (float) (-2.0 / (juce::MathConstants<double>::pi * harmonic));
+            const auto squareGain = (harmonic % 2 == 1) ? (float) (4.0 / (juce::MathConstants<double>::pi * harmonic)) : 0.0f;
+            
+            for (int i = 0; i < tableSize; ++i)
+            {
+                const float basis = sineTable[(size_t) ((harmonic * i) & (tableSize - 1))];
+                sawTable[i] += sawGain * basis;
+                squareTable[i] += squareGain * basis;
+            }
+        }
+        
+        sawTable[tableSize] = sawTable[0];
+        squareTable[tableSize] = squareTable[0];
+    }
+}
+
+const float* RiserOscillatorBank::getTable(Voice voice, float increment) const
+{
+    if (voice == sine || voice == sub)
+        return sineTable.data();
+    
+    // Lowest level whose top frequency is at or above this one
+    const auto frequency = (double) increment * sampleRate;
+    const int level = frequency <= baseFrequency ? 0
+                    : juce::jmin(numLevels - 1, (int) std::ceil(std::log2(frequency / baseFrequency)));
+    
+    const auto& tables = voice == saw ? sawTables : squareTables;
+    return tables.data() + (size_t) level * (size_t) (tableSize + 1);
+}
+
+void RiserOscillatorBank::render(Voice voice, float* output, int numSamples, float startFrequency, float endFrequency)
+{
+    if (numSamples <= 0)
+        return;
+    
+    const auto startIncrement = (float) (startFrequency / sampleRate);
+    const auto endIncrement = (float) (endFrequency / sampleRate);
+    const auto incrementStep = numSamples > 1 ? (endIncrement - startIncrement) / (float) (numSamples - 1) : 0.0f;
+    float phase = phases[voice];
+    
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const int count = juce::jmin(chunkSize, numSamples - start);
+        const float increment = startIncrement + incrementStep * (float) start;
+        const float lastIncrement = increment + incrementStep * (float) (count - 1);
+        const float* table = getTable(voice, juce::jmax(increment, lastIncrement));
+        float* dest = output + start;
+        
+        // Table position of every sample: the phase after i steps whose
+        // increment grows by incrementStep each time, wrapped to [0, 1)
+        for (int i = 0; i < count; ++i)
+        {
+            const auto n = (float) i;
+            const float p = phase + n * increment + 0.5f * n * (n - 1.0f) * incrementStep;
+            dest[i] = (p - (float) (int) p) * (float) tableSize;
+        }
+        
+        for (int i = 0; i < count; ++i)
+        {
+            const float position = dest[i];
+            const int index = (int) position;
+            const float fraction = position - (float) index;
+            dest[i] = table[index] + fraction * (table[index + 1] - table[index]);
+        }
+        
+        const auto n = (float) count;
+        phase += n * increment + 0.5f * n * (n - 1.0f) * incrementStep;
+        phase -= (float) (int) phase;
+    }
+    
+    phases[voice] = phase;
+}
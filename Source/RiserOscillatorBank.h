@@ -0,0 +1,56 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+// Oscillators for the tonal risers. Every voice reads a wavetable: sine and
+// sub share one sine table, while saw and square have a mip-map of
+// band-limited tables, one per octave of fundamental, each holding only the
+// harmonics that stay below Nyquist at the top of its octave. A sweep to
+// 4kHz therefore doesn't alias.
+//
+// render() works in chunks: one loop computes each sample's phase in closed
+// form, with no wrap test, and a second does the interpolated table reads.
+// The frequency moves linearly from start to end across the block, and each
+// chunk reads the table for the highest frequency it reaches.
+class RiserOscillatorBank
+{
+public:
+    enum Voice
+    {
+        sine = 0,
+        saw,
+        square,
+        sub,
+        numVoices
+    };
+    
+    RiserOscillatorBank() = default;
+    
+    // Builds the tables for the sample rate (only when it changes) and resets
+    // every phase; not real-time safe
+    void prepare(double sampleRate);
+    void reset();
+    
+    // Writes numSamples of the voice at unit amplitude to output, advancing
+    // its phase. The frequency goes from startFrequency at the first sample
+    // to endFrequency at the last.
+    void render(Voice voice, float* output, int numSamples, float startFrequency, float endFrequency);
+
+private:
+    static constexpr int tableSize = 2048;      // Power of two; tables hold one guard point
+    static constexpr int chunkSize = 64;
+    static constexpr float baseFrequency = 40.0f; // Top of the lowest mip level
+    
+    void buildTables();
+    
+    // The table to read at this phase increment for the voice
+    const float* getTable(Voice voice, float increment) const;
+    
+    std::vector<float> sineTable;
+    std::vector<float> sawTables, squareTables;  // numLevels tables of tableSize + 1
+    int numLevels = 0;
+    
+    float phases[numVoices] = {};
+    double sampleRate = 0.0;
+};
@@ -0,0 +1,28 @@
+#include "ScratchBuffers.h"
+
+void ScratchBuffers::prepare(int numChannels, int maximumBlockSize)
+{
+    channelsPerSlot = juce::jmax(1, numChannels);
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+    
+    storage.setSize(channelsPerSlot * numSlots, maxBlockSize);
+    storage.clear();
+}
+
+juce::AudioBuffer<float>& ScratchBuffers::get(Slot slot, int numChannels, int numSamples)
+{
+    // Hosts shouldn't exceed the size given to prepareToPlay, but if one does we
+    // grow rather than write out of bounds. This is the only allocating path.
+    if (numChannels > channelsPerSlot || numSamples > maxBlockSize)
+    {
+        jassertfalse;
+        prepare(juce::jmax(numChannels, channelsPerSlot), juce::jmax(numSamples, maxBlockSize));
+    }
+    
+    // Referring to existing channel pointers uses the buffer's inline channel
+    // array, so this doesn't allocate
+    auto& view = views[(size_t) slot];
+    view.setDataToReferTo(storage.getArrayOfWritePointers() + slot * channelsPerSlot,
+                          numChannels, numSamples);
+    return view;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+
+// Preallocated scratch memory for the temporary buffers processBlock needs.
+// Everything is sized in prepare() so the audio thread never touches the heap;
+// get() just hands out a view onto the slot's channels.
+class ScratchBuffers
+{
+public:
+    enum Slot
+    {
+        vocoderOutput = 0,  // Vocoder noise before it is mixed into the main buffer
+        reverbSend,         // Reverb return, mixed back in at the end of the chain
+        riserNoise,         // Noise Sweep riser, one channel
+        riserVoice,         // Tonal riser oscillator, one channel
+        modulation,         // Tremolo gain or pan curve, one channel
+        numSlots
+    };
+    
+    ScratchBuffers() = default;
+    ~ScratchBuffers() = default;
+    
+    void prepare(int numChannels, int maximumBlockSize);
+    
+    // Returns a view of numChannels x numSamples for the given slot. Contents are
+    // whatever the slot held last block - clear it if the caller accumulates.
+    juce::AudioBuffer<float>& get(Slot slot, int numChannels, int numSamples);
+    
+    int getMaximumBlockSize() const { return maxBlockSize; }
+    
+private:
+    juce::AudioBuffer<float> storage; // numSlots * channelsPerSlot channels
+    std::array<juce::AudioBuffer<float>, numSlots> views;
+    int channelsPerSlot = 0;
+    int maxBlockSize = 0;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScratchBuffers)
+};
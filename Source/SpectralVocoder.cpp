@@ -0,0 +1,198 @@
+#include "SpectralVocoder.h"
+#include "NoiseEngine.h"
+#include <cmath>
+
+namespace
+{
+    // Hann windows on analysis and synthesis overlap to sum(w^2) = 1.5 at 75%
+    constexpr float overlapAddGain = 1.0f / 1.5f;
+    
+    // Puts the spectral vocoder at roughly the filterbank vocoder's level
+    constexpr float outputGain = 10.0f;
+}
+
+SpectralVocoder::SpectralVocoder(NoiseEngine& noiseSource)
+    : window((size_t) fftSize),
+      inputSpectrum((size_t) fftSize * 2, 0.0f),
+      noiseSpectrum((size_t) fftSize * 2, 0.0f),
+      tilt((size_t) numBins, 1.0f),
+      noiseEngine(noiseSource)
+{
+    // Periodic Hann, so overlapping windows sum exactly
+    for (int i = 0; i < fftSize; ++i)
+        window[(size_t) i] = 0.5f - 0.5f * std::cos(2.0f * juce::MathConstants<float>::pi * (float) i / (float) fftSize);
+}
+
+void SpectralVocoder::prepare(double newSampleRate, int numChannels)
+{
+    jassert (noiseEngine.getNumChannels() >= numChannels);
+    
+    sampleRate = newSampleRate;
+    channels.resize((size_t) numChannels);
+    
+    for (auto& channel : channels)
+    {
+        channel.inputFrame.assign((size_t) fftSize, 0.0f);
+        channel.outputSum.assign((size_t) fftSize, 0.0f);
+        channel.outputReady.assign((size_t) hopSize, 0.0f);
+        channel.envelope.assign((size_t) numBins, 0.0f);
+    }
+    
+    // Coefficients depend on the sample rate
+    currentRelease = currentBrightness = -1.0f;
+    isClear = false;
+    reset();
+}
+
+void SpectralVocoder::reset()
+{
+    if (isClear)
+        return;
+    
+    for (auto& channel : channels)
+    {
+        std::fill(channel.inputFrame.begin(), channel.inputFrame.end(), 0.0f);
+        std::fill(channel.outputSum.begin(), channel.outputSum.end(), 0.0f);
+        std::fill(channel.outputReady.begin(), channel.outputReady.end(), 0.0f);
+        std::fill(channel.envelope.begin(), channel.envelope.end(), 0.0f);
+    }
+    
+    hopPosition = 0;
+    isClear = true;
+}
+
+void SpectralVocoder::process(const juce::AudioBuffer<float>& input,
+                              juce::AudioBuffer<float>& output,
+                              const Parameters& parameters)
+{
+    const float gain = parameters.gain;
+    const float release = parameters.release;
+    const float brightness = parameters.brightness;
+    
+    const int numSamples = input.getNumSamples();
+    const int numChannels = juce::jmin(input.getNumChannels(), output.getNumChannels(), (int) channels.size());
+    
+    updateEnvelopeCoefficients(release);
+    updateTilt(brightness);
+    isClear = false;
+    
+    // Work through the block a hop boundary at a time: copy in what the next
+    // frame still needs, copy out the same span of finished output
+    for (int position = 0; position < numSamples;)
+    {
+        const int numToCopy = juce::jmin(numSamples - position, hopSize - hopPosition);
+        
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& channel = channels[(size_t) ch];
+            
+            juce::FloatVectorOperations::copy(channel.inputFrame.data() + (fftSize - hopSize + hopPosition),
+                                              input.getReadPointer(ch, position), numToCopy);
+            juce::FloatVectorOperations::copyWithMultiply(output.getWritePointer(ch, position),
+                                                          channel.outputReady.data() + hopPosition,
+                                                          gain, numToCopy);
+        }
+        
+        hopPosition += numToCopy;
+        position += numToCopy;
+        
+        if (hopPosition == hopSize)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                processFrame(ch);
+            
+            hopPosition = 0;
+        }
+    }
+}
+
+void SpectralVocoder::processFrame(int channelIndex)
+{
+    auto& channel = channels[(size_t) channelIndex];
+    auto* inputData = inputSpectrum.data();
+    auto* noiseData = noiseSpectrum.data();
+    
+    // Windowed input frame
+    juce::FloatVectorOperations::multiply(inputData, channel.inputFrame.data(), window.data(), fftSize);
+    fft.performRealOnlyForwardTransform(inputData, true);
+    
+    // Windowed noise carrier frame
+    noiseEngine.fill(channelIndex, noiseData, fftSize);
+    juce::FloatVectorOperations::multiply(noiseData, window.data(), fftSize);
+    fft.performRealOnlyForwardTransform(noiseData, true);
+    
+    // Scale each noise bin by the input's smoothed magnitude in that bin.
+    // 2 / sum(window) turns a bin magnitude back into a sine amplitude.
+    const float magnitudeScale = 4.0f / (float) fftSize;
+    auto* envelope = channel.envelope.data();
+    
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const float re = inputData[2 * bin];
+        const float im = inputData[2 * bin + 1];
+        const float magnitude = std::sqrt(re * re + im * im) * magnitudeScale;
+        
+        const float coeff = magnitude > envelope[bin] ? attackCoeff : releaseCoeff;
+        envelope[bin] += (magnitude - envelope[bin]) * coeff;
+        
+        const float binGain = envelope[bin] * tilt[(size_t) bin];
+        noiseData[2 * bin] *= binGain;
+        noiseData[2 * bin + 1] *= binGain;
+    }
+    
+    // Mirror the negative frequencies so the inverse sees a full real spectrum
+    for (int bin = numBins; bin < fftSize; ++bin)
+    {
+        noiseData[2 * bin] = noiseData[2 * (fftSize - bin)];
+        noiseData[2 * bin + 1] = -noiseData[2 * (fftSize - bin) + 1];
+    }
+    
+    fft.performRealOnlyInverseTransform(noiseData);
+    
+    // Synthesis window, overlap-add, then hand the finished hop to the output
+    juce::FloatVectorOperations::multiply(noiseData, window.data(), fftSize);
+    juce::FloatVectorOperations::add(channel.outputSum.data(), noiseData, fftSize);
+    
+    juce::FloatVectorOperations::copyWithMultiply(channel.outputReady.data(), channel.outputSum.data(),
+                                                  overlapAddGain * outputGain, hopSize);
+    
+    std::copy(channel.outputSum.begin() + hopSize, channel.outputSum.end(), channel.outputSum.begin());
+    std::fill(channel.outputSum.end() - hopSize, channel.outputSum.end(), 0.0f);
+    
+    // Slide the input frame along by one hop
+    std::copy(channel.inputFrame.begin() + hopSize, channel.inputFrame.end(), channel.inputFrame.begin());
+}
+
+void SpectralVocoder::updateEnvelopeCoefficients(float release)
+{
+    if (release == currentRelease)
+        return;
+    
+    currentRelease = release;
+    
+    // Same times as the filterbank vocoder, applied once per hop
+    const float attackMs = 0.5f;
+    const float releaseMs = 10.0f + release * 990.0f;
+    const auto hopsPerMs = 0.001 * sampleRate / hopSize;
+    
+    attackCoeff = 1.0f - (float) std::exp(-1.0 / (attackMs * hopsPerMs));
+    releaseCoeff = 1.0f - (float) std::exp(-1.0 / (releaseMs * hopsPerMs));
+}
+
+void SpectralVocoder::updateTilt(float brightness)
+{
+    if (brightness == currentBrightness)
+        return;
+    
+    currentBrightness = brightness;
+    
+    // Spectral tilt around 3kHz: -3dB/oct when warm up to +6dB/oct when bright
+    const float exponent = -0.5f + 1.5f * brightness;
+    const auto binHz = (float) (sampleRate / fftSize);
+    
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const float frequency = juce::jmax(200.0f, (float) bin * binHz);
+        tilt[(size_t) bin] = std::pow(frequency / 3000.0f, exponent);
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+#include "VocoderEngine.h"
+
+// STFT noise vocoder. Every hop, the windowed input frame and a windowed frame
+// of white noise are both transformed; each noise bin is scaled by the input's
+// smoothed magnitude in that bin (its spectral envelope), transformed back and
+// overlap-added. Input is gathered a hop at a time with block copies, so the
+// work per hop doesn't depend on the host block size.
+//
+// Output lags the input by one frame (fftSize samples). The processor doesn't
+// report or compensate that: nothing else in the signal path is delayed to
+// match, so like the filterbank's envelope lag it is part of the effect.
+class SpectralVocoder : public VocoderEngine
+{
+public:
+    static constexpr int fftOrder = 10;              // 1024 samples
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 4;      // 75% overlap
+    static constexpr int numBins = fftSize / 2 + 1;
+    
+    // The carrier noise for each channel is drawn from that channel's
+    // stream of noiseSource
+    explicit SpectralVocoder(NoiseEngine& noiseSource);
+    
+    void prepare(double sampleRate, int numChannels) override;
+    void reset() override;
+    void process(const juce::AudioBuffer<float>& input,
+                 juce::AudioBuffer<float>& output,
+                 const Parameters& parameters) override;
+
+private:
+    struct Channel
+    {
+        std::vector<float> inputFrame;   // Last fftSize input samples, oldest first
+        std::vector<float> outputSum;    // Overlap-add accumulator
+        std::vector<float> outputReady;  // The hop currently being played out
+        std::vector<float> envelope;     // Smoothed magnitude per bin
+    };
+    
+    void processFrame(int channelIndex);
+    void updateEnvelopeCoefficients(float release);
+    void updateTilt(float brightness);
+    
+    juce::dsp::FFT fft { fftOrder };
+    std::vector<float> window;
+    std::vector<float> inputSpectrum;    // 2 * fftSize, as the FFT wants
+    std::vector<float> noiseSpectrum;
+    std::vector<float> tilt;             // Per-bin brightness gain
+    std::vector<Channel> channels;
+    NoiseEngine& noiseEngine;
+    
+    double sampleRate = 44100.0;
+    int hopPosition = 0;                 // Samples gathered towards the next hop
+    bool isClear = true;
+    
+    float attackCoeff = 1.0f, releaseCoeff = 1.0f;
+    float currentRelease = -1.0f, currentBrightness = -1.0f;
+};
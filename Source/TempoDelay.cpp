@@ -0,0 +1,182 @@
+#include "TempoDelay.h"
+#include "DriveStage.h"
+#include <cmath>
+
+void TempoDelay::prepare(double newSampleRate, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    numChannels = newNumChannels;
+    lineLength = (int) std::ceil(maxDelaySeconds * sampleRate) + 1;
+    lines.setSize(juce::jmax(1, numChannels), lineLength + 1);
+    fadeLength = juce::jmax(1, juce::roundToInt(crossfadeSeconds * sampleRate));
+    
+    delay = targetDelay = -1.0;
+    reset();
+}
+
+void TempoDelay::reset()
+{
+    lines.clear();
+    writePosition = 0;
+    
+    // Nothing to fade between in silent lines
+    if (targetDelay >= 0.0)
+        delay = targetDelay;
+    
+    fading = false;
+}
+
+void TempoDelay::setDelaySeconds(double seconds)
+{
+    targetDelay = juce::jlimit(1.0, (double) (lineLength - 1), seconds * sampleRate);
+    
+    if (delay < 0.0)
+        delay = targetDelay;
+}
+
+TempoDelay::Tap TempoDelay::getTap(double delaySamples) const
+{
+    // The read point is writePosition - delaySamples: split the delay so the
+    // whole samples index the line and the rest weights the interpolation
+    const auto wholeSamples = (int) delaySamples;
+    const auto fraction = (float) (delaySamples - wholeSamples);
+    
+    Tap tap;
+    tap.index = writePosition - wholeSamples - (fraction > 0.0f ? 1 : 0);
+    tap.fraction = fraction > 0.0f ? 1.0f - fraction : 0.0f;
+    
+    if (tap.index < 0)
+        tap.index += lineLength;
+    
+    return tap;
+}
+
+int TempoDelay::getSamplesToWrap(const Tap& tap) const
+{
+    return lineLength - tap.index;
+}
+
+void TempoDelay::readTap(const float* line, const Tap& tap, float* dest, int numSamples)
+{
+    const float* source = line + tap.index;
+    
+    for (int i = 0; i < numSamples; ++i)
+        dest[i] = source[i] + tap.fraction * (source[i + 1] - source[i]);
+}
+
+void TempoDelay::startFadeIfNeeded()
+{
+    if (fading || targetDelay == delay || targetDelay < 0.0)
+        return;
+    
+    fadeDelay = targetDelay;
+    fadePosition = 0;
+    fading = true;
+}
+
+void TempoDelay::advanceWritePosition(int numSamples)
+{
+    // Refresh the guard whenever sample 0 is rewritten
+    if (writePosition == 0)
+    {
+        for (int channel = 0; channel < lines.getNumChannels(); ++channel)
+            lines.setSample(channel, lineLength, lines.getSample(channel, 0));
+    }
+    
+    writePosition += numSamples;
+    
+    if (writePosition >= lineLength)
+        writePosition -= lineLength;
+}
+
+void TempoDelay::process(juce::AudioBuffer<float>& buffer, float mix, float feedbackGain)
+{
+    const int channelsToProcess = juce::jmin(numChannels, buffer.getNumChannels());
+    const int numSamples = buffer.getNumSamples();
+    
+    if (delay < 0.0 || lineLength == 0)
+        return;
+    
+    alignas (16) float delayed[maxRunLength];
+    alignas (16) float faded[maxRunLength];
+    
+    for (int start = 0; start < numSamples;)
+    {
+        startFadeIfNeeded();
+        
+        const auto tap = getTap(delay);
+        const auto fadeTap = getTap(fading ? fadeDelay : delay);
+        const double shortestDelay = fading ? juce::jmin(delay, fadeDelay) : delay;
+        
+        int count = juce::jmin(numSamples - start, maxRunLength, lineLength - writePosition);
+        count = juce::jmin(count, (int) shortestDelay, getSamplesToWrap(tap));
+        
+        if (fading)
+            count = juce::jmin(count, getSamplesToWrap(fadeTap), fadeLength - fadePosition);
+        
+        for (int channel = 0; channel < channelsToProcess; ++channel)
+        {
+            float* line = lines.getWritePointer(channel);
+            float* data = buffer.getWritePointer(channel, start);
+            
+            readTap(line, tap, delayed, count);
+            
+            if (fading)
+            {
+                // Linear crossfade from the old tap to the new one
+                readTap(line, fadeTap, faded, count);
+                const float fadeStep = 1.0f / (float) fadeLength;
+                const float firstGain = (float) (fadePosition + 1) * fadeStep;
+                
+                for (int i = 0; i < count; ++i)
+                    delayed[i] += (firstGain + (float) i * fadeStep) * (faded[i] - delayed[i]);
+            }
+            
+            float* write = line + writePosition;
+            
+            for (int i = 0; i < count; ++i)
+            {
+                write[i] = data[i] + delayed[i] * feedbackGain;
+                data[i] += delayed[i] * mix;
+            }
+            
+            // Soft clip to prevent overload
+            DriveStage::saturate(write, count, 1.0f, 1.0f);
+        }
+        
+        // Channels without input still hold their line's silence
+        for (int channel = channelsToProcess; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::clear(lines.getWritePointer(channel, writePosition), count);
+        
+        if (fading)
+        {
+            fadePosition += count;
+            
+            if (fadePosition >= fadeLength)
+            {
+                delay = fadeDelay;
+                fading = false;
+            }
+        }
+        
+        advanceWritePosition(count);
+        start += count;
+    }
+}
+
+void TempoDelay::advance(int numSamples)
+{
+    if (lineLength == 0)
+        return;
+    
+    for (int start = 0; start < numSamples;)
+    {
+        const int count = juce::jmin(numSamples - start, lineLength - writePosition);
+        
+        for (int channel = 0; channel < lines.getNumChannels(); ++channel)
+            juce::FloatVectorOperations::clear(lines.getWritePointer(channel, writePosition), count);
+        
+        advanceWritePosition(count);
+        start += count;
+    }
+}
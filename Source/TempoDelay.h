@@ -0,0 +1,81 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// The tempo delay: one circular line per channel, a feedback path through a
+// soft clipper, and the delayed signal added to the dry one.
+//
+// The delay time is fractional. A tap is read with linear interpolation at a
+// fixed weight, so it stays a straight loop. When the time changes, the old
+// tap crossfades to the new one over crossfadeSeconds instead of jumping. A
+// change that arrives mid-fade waits for the fade to finish.
+//
+// process() works on contiguous runs. A run stops at the wrap point of the
+// line and of each tap, at the end of a fade, and short of the delay, so it
+// never reads a sample it writes. Within a run every channel is a few plain
+// loops the compiler vectorises, and the clipper is DriveStage::saturate.
+class TempoDelay
+{
+public:
+    static constexpr double maxDelaySeconds = 2.0;
+    static constexpr double crossfadeSeconds = 0.05;
+    
+    TempoDelay() = default;
+    
+    // Allocates a line per channel; not real-time safe
+    void prepare(double sampleRate, int numChannels);
+    
+    // Silences the lines and jumps straight to the latest delay time
+    void reset();
+    
+    // Clamped to one sample to maxDelaySeconds. The first call after
+    // prepare() takes effect at once; later ones crossfade.
+    void setDelaySeconds(double seconds);
+    
+    // Adds the delayed signal times mix to buffer, and writes
+    // softclip(input + delayed x feedbackGain) back into the line. Channels
+    // beyond those prepared are left alone.
+    void process(juce::AudioBuffer<float>& buffer, float mix, float feedbackGain);
+    
+    // Writes numSamples of silence, so the lines empty while the delay is
+    // off. A pending time change waits for the next process().
+    void advance(int numSamples);
+
+private:
+    // Samples a run handles at most, for the stack scratch
+    static constexpr int maxRunLength = 256;
+    
+    // Where a tap reads: sample index + fraction x (index + 1)
+    struct Tap
+    {
+        int index = 0;
+        float fraction = 0.0f;
+    };
+    
+    Tap getTap(double delaySamples) const;
+    
+    // Samples until the tap's next read crosses the end of the line
+    int getSamplesToWrap(const Tap& tap) const;
+    
+    // dest[i] = line at the tap, i samples on
+    static void readTap(const float* line, const Tap& tap, float* dest, int numSamples);
+    
+    void startFadeIfNeeded();
+    void advanceWritePosition(int numSamples);
+    
+    // Each line is lineLength samples plus a guard copy of sample 0, so the
+    // interpolated read at the last sample needs no wrap
+    juce::AudioBuffer<float> lines;
+    int lineLength = 0;
+    int numChannels = 0;
+    int writePosition = 0;
+    
+    double delay = -1.0;        // Samples; the tap that is playing, < 0 until set
+    double targetDelay = -1.0;  // The latest setDelaySeconds
+    double fadeDelay = 0.0;     // The tap being faded in
+    int fadeLength = 1;
+    int fadePosition = 0;
+    bool fading = false;
+    
+    double sampleRate = 44100.0;
+};
@@ -0,0 +1,124 @@
+#include "VocoderBandBank.h"
+#include <cmath>
+
+void VocoderBandBank::prepare(double newSampleRate, int numChannels)
+{
+    sampleRate = newSampleRate;
+    channels.resize((size_t) numChannels);
+    
+    // Force the envelope coefficients to follow the new rate
+    const auto attack = attackMs, release = releaseMs;
+    attackMs = releaseMs = -1.0f;
+    setAttackMs(attack > 0.0f ? attack : 1.0f);
+    setReleaseMs(release > 0.0f ? release : 10.0f);
+    
+    reset();
+}
+
+void VocoderBandBank::setBands(int numBands,
+                               const float* centreFrequencies,
+                               const float* analysisResonances)
+{
+    jassert (numBands > 0 && numBands <= maxBands && numBands % lanesPerVec == 0);
+    numGroups = juce::jlimit(1, maxGroups, numBands / lanesPerVec);
+    
+    // Keep every centre clear of Nyquist, where tan() runs away
+    const auto maxCentre = (float) (sampleRate * 0.45);
+    
+    for (int i = 0; i < numGroups; ++i)
+    {
+        alignas (16) float gs[lanesPerVec], aK[lanesPerVec], aH[lanesPerVec];
+        
+        for (int lane = 0; lane < lanesPerVec; ++lane)
+        {
+            const int band = i * lanesPerVec + lane;
+            const auto centre = juce::jmin(centreFrequencies[band], maxCentre);
+            const auto bandG = (float) std::tan(juce::MathConstants<double>::pi * centre / sampleRate);
+            const auto analysisR2 = 1.0f / analysisResonances[band];
+            
+            gs[lane] = bandG;
+            aK[lane] = bandG + analysisR2;
+            aH[lane] = 1.0f / (1.0f + analysisR2 * bandG + bandG * bandG);
+        }
+        
+        g[i] = Vec::fromRawArray(gs);
+        analysisK[i] = Vec::fromRawArray(aK);
+        analysisH[i] = Vec::fromRawArray(aH);
+    }
+    
+    reset();
+}
+
+void VocoderBandBank::reset()
+{
+    const auto zero = Vec::expand(0.0f);
+    
+    for (auto& state : channels)
+    {
+        for (int i = 0; i < maxGroups; ++i)
+        {
+            state.analysisS1[i] = state.analysisS2[i] = zero;
+            state.peak[i] = state.envelope[i] = zero;
+            state.smoothed[i] = state.step[i] = zero;
+        }
+        
+        state.samplesToStep = 1;
+    }
+}
+
+void VocoderBandBank::setAttackMs(float ms)
+{
+    if (ms == attackMs)
+        return;
+    
+    attackMs = ms;
+    attackCoeff = Vec::expand(envelopeCoefficient(ms, sampleRate / decimation));
+}
+
+void VocoderBandBank::setReleaseMs(float ms)
+{
+    if (ms == releaseMs)
+        return;
+    
+    releaseMs = ms;
+    releaseCoeff = Vec::expand(envelopeCoefficient(ms, sampleRate / decimation));
+}
+
+void VocoderBandBank::setEnvelopeDecimation(int factor)
+{
+    factor = juce::jmax(1, factor);
+    
+    if (factor == decimation)
+        return;
+    
+    decimation = factor;
+    inverseDecimation = 1.0f / (float) factor;
+    
+    // The follower coefficients are per step, so they follow the control rate
+    if (attackMs > 0.0f)
+        attackCoeff = Vec::expand(envelopeCoefficient(attackMs, sampleRate / decimation));
+    
+    if (releaseMs > 0.0f)
+        releaseCoeff = Vec::expand(envelopeCoefficient(releaseMs, sampleRate / decimation));
+    
+    // The per-sample path only keeps envelope up to date, so pick the ramp up
+    // from there instead of from a stale (or zero) smoothed value
+    const auto zero = Vec::expand(0.0f);
+    
+    for (auto& state : channels)
+    {
+        for (int i = 0; i < maxGroups; ++i)
+        {
+            state.smoothed[i] = state.envelope[i];
+            state.step[i] = zero;
+            state.peak[i] = zero;
+        }
+        
+        state.samplesToStep = decimation;
+    }
+}
+
+float VocoderBandBank::envelopeCoefficient(float ms, double rate)
+{
+    return 1.0f - std::exp(-1.0f / (ms * 0.001f * (float) rate));
+}
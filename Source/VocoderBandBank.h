@@ -0,0 +1,163 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+// The filterbank vocoder's per-band work - analysis bandpass, envelope follower
+// and carrier modulation - one band per SIMD lane. Bands come in groups of
+// lanesPerVec, and every per-band value is stored as an array of registers
+// (struct-of-arrays), so the cost grows linearly with the band count.
+// The filters use the same TPT state variable update as
+// juce::dsp::StateVariableTPTFilter (bandpass output), so results match the
+// per-band filter objects to float rounding. The band-limited noise carriers
+// come ready-filtered from a VocoderCarrierCache. No per-sample denormal
+// handling: run under juce::ScopedNoDenormals.
+//
+// The envelope followers can run at a decimated control rate: each band's
+// rectified output is peak-held over the decimation factor's worth of samples,
+// the follower steps once per block of that many, and the envelope applied to
+// the carriers is ramped linearly between steps. A factor of 1 runs the
+// follower on every sample.
+class VocoderBandBank
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    
+    static constexpr int lanesPerVec = (int) Vec::SIMDNumElements;
+    static constexpr int maxBands = 32;
+    static constexpr int maxGroups = maxBands / lanesPerVec;
+    
+    static_assert (maxBands % lanesPerVec == 0, "Bands must fill whole SIMD registers");
+    
+    VocoderBandBank() = default;
+    
+    // Allocates numChannels independent channels of state. Call setBands
+    // afterwards so the coefficients match the new sample rate.
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+    
+    // numBands must be a multiple of lanesPerVec and at most maxBands; the
+    // arrays hold numBands values each. Doesn't allocate, so it can be called
+    // from the audio thread, but it resets every filter.
+    void setBands(int numBands,
+                  const float* centreFrequencies,
+                  const float* analysisResonances);
+    int getNumBands() const { return numGroups * lanesPerVec; }
+    int getNumGroups() const { return numGroups; }
+    
+    // Envelope times are shared by every band; coefficients are only
+    // recomputed when the time actually changes
+    void setAttackMs(float ms);
+    void setReleaseMs(float ms);
+    
+    // Samples per envelope follower step, 1 or more. Doesn't allocate.
+    void setEnvelopeDecimation(int factor);
+    int getEnvelopeDecimation() const { return decimation; }
+    
+    int getNumChannels() const { return (int) channels.size(); }
+    
+    // Runs input through the analysis bands and returns the sum over bands of
+    // carrier x envelope x gain. carriers and bandGains hold one register per
+    // group.
+    inline float processSample(int channel, float input, const Vec* carriers, const Vec* bandGains);
+
+private:
+    struct ChannelState
+    {
+        Vec analysisS1[maxGroups], analysisS2[maxGroups];
+        Vec envelope[maxGroups];        // Follower output
+        
+        // Decimated follower only
+        Vec peak[maxGroups];            // Rectified peak since the last follower step
+        Vec smoothed[maxGroups];        // Ramped envelope applied to the carriers
+        Vec step[maxGroups];
+        int samplesToStep = 1;
+    };
+    
+    static float envelopeCoefficient(float ms, double rate);
+    inline Vec processAnalysis(ChannelState& state, int group, Vec input) const;
+    inline void stepEnvelopes(ChannelState& state);
+    
+    std::vector<ChannelState> channels;
+    
+    // SVF coefficients: g = tan(pi fc / fs), k = g + 1/Q, h = 1 / (1 + g/Q + g^2)
+    Vec g[maxGroups], analysisK[maxGroups], analysisH[maxGroups];
+    Vec attackCoeff, releaseCoeff;
+    int numGroups = 0;
+    int decimation = 1;
+    float inverseDecimation = 1.0f;
+    
+    double sampleRate = 44100.0;
+    float attackMs = -1.0f, releaseMs = -1.0f;
+};
+
+inline float VocoderBandBank::processSample(int channel, float input, const Vec* carriers, const Vec* bandGains)
+{
+    auto& state = channels[(size_t) channel];
+    
+    const auto x = Vec::expand(input);
+    auto output = Vec::expand(0.0f);
+    
+    if (decimation == 1)
+    {
+        for (int i = 0; i < numGroups; ++i)
+        {
+            const auto analysisBP = processAnalysis(state, i, x);
+            
+            // Envelope follower: attack coefficient in the lanes that are rising
+            const auto rectified = Vec::abs(analysisBP);
+            const auto rising = Vec::greaterThan(rectified, state.envelope[i]);
+            const auto coeff = (attackCoeff & rising) + (releaseCoeff & ~rising);
+            state.envelope[i] += (rectified - state.envelope[i]) * coeff;
+            
+            output += carriers[i] * state.envelope[i] * bandGains[i];
+        }
+        
+        return output.sum();
+    }
+    
+    for (int i = 0; i < numGroups; ++i)
+    {
+        const auto analysisBP = processAnalysis(state, i, x);
+        state.peak[i] = Vec::max(state.peak[i], Vec::abs(analysisBP));
+        
+        output += carriers[i] * state.smoothed[i] * bandGains[i];
+        state.smoothed[i] += state.step[i];
+    }
+    
+    if (--state.samplesToStep == 0)
+        stepEnvelopes(state);
+    
+    return output.sum();
+}
+
+inline VocoderBandBank::Vec VocoderBandBank::processAnalysis(ChannelState& state, int group, Vec x) const
+{
+    // Analysis bandpass
+    const int i = group;
+    const auto analysisHP = (x - state.analysisS1[i] * analysisK[i] - state.analysisS2[i]) * analysisH[i];
+    const auto analysisBP = analysisHP * g[i] + state.analysisS1[i];
+    state.analysisS1[i] = analysisHP * g[i] + analysisBP;
+    state.analysisS2[i] = analysisBP * g[i] + (analysisBP * g[i] + state.analysisS2[i]);
+    return analysisBP;
+}
+
+inline void VocoderBandBank::stepEnvelopes(ChannelState& state)
+{
+    const auto zero = Vec::expand(0.0f);
+    
+    for (int i = 0; i < numGroups; ++i)
+    {
+        // Envelope follower: attack coefficient in the lanes that are rising
+        const auto rising = Vec::greaterThan(state.peak[i], state.envelope[i]);
+        const auto coeff = (attackCoeff & rising) + (releaseCoeff & ~rising);
+        state.envelope[i] += (state.peak[i] - state.envelope[i]) * coeff;
+        
+        // Reach the new value by the next step
+        state.step[i] = (state.envelope[i] - state.smoothed[i]) * inverseDecimation;
+        state.peak[i] = zero;
+    }
+    
+    state.samplesToStep = decimation;
+}
@@ -0,0 +1,143 @@
+#include "VocoderCarrierCache.h"
+#include <cmath>
+#include <complex>
+
+VocoderCarrierCache::VocoderCarrierCache()
+    : fadeIn((size_t) fadeLength),
+      random(juce::Random::getSystemRandom().nextInt64())
+{
+    for (int i = 0; i < fadeLength; ++i)
+        fadeIn[(size_t) i] = std::sin(juce::MathConstants<float>::halfPi * ((float) i + 0.5f) / (float) fadeLength);
+}
+
+void VocoderCarrierCache::prepare(double newSampleRate, int numChannels, const LayoutFunction& getLayout)
+{
+    if (newSampleRate != sampleRate || tableSet == nullptr)
+    {
+        // Release the old set first, so the store can drop it if this was
+        // its last user
+        tableSet.reset();
+        rows = nullptr;
+        numGroups = 0;
+        sampleRate = newSampleRate;
+        tableSet = store->get(sampleRate, getLayout);
+    }
+    
+    channels.assign((size_t) numChannels, ChannelState());
+    
+    // Start every channel somewhere different, and stagger the jumps
+    for (auto& state : channels)
+    {
+        state.position = random.nextInt(tableLength);
+        state.samplesToJump = 1 + random.nextInt(segmentLength);
+    }
+}
+
+void VocoderCarrierCache::setSeed(juce::int64 seed)
+{
+    random.setSeed(seed);
+}
+
+int VocoderCarrierCache::layoutIndex(int numBands)
+{
+    jassert (juce::isPowerOfTwo(numBands) && numBands >= VocoderBandBank::lanesPerVec && numBands <= VocoderBandBank::maxBands);
+    return juce::jlimit(0, maxLayouts - 1, juce::findHighestSetBit((juce::uint32) (numBands / VocoderBandBank::lanesPerVec)));
+}
+
+std::shared_ptr<const VocoderCarrierCache::TableSet> VocoderCarrierCache::SharedStore::get(double sampleRate, const LayoutFunction& getLayout)
+{
+    const juce::ScopedLock sl (lock);
+    
+    if (auto existing = tableSets[sampleRate].lock())
+        return existing;
+    
+    // Forget sets nobody holds any more
+    for (auto it = tableSets.begin(); it != tableSets.end();)
+        it = it->second.expired() ? tableSets.erase(it) : std::next(it);
+    
+    auto tableSet = std::make_shared<TableSet>();
+    
+    for (int count = VocoderBandBank::lanesPerVec; count <= VocoderBandBank::maxBands; count *= 2)
+    {
+        float centres[VocoderBandBank::maxBands], resonances[VocoderBandBank::maxBands];
+        getLayout(count, centres, resonances);
+        buildLayout(tableSet->tables[layoutIndex(count)], sampleRate, count, centres, resonances);
+    }
+    
+    tableSets[sampleRate] = tableSet;
+    return tableSet;
+}
+
+void VocoderCarrierCache::buildLayout(std::vector<Vec>& table, double sampleRate, int numBands,
+                                      const float* centreFrequencies, const float* resonances)
+{
+    const int groups = numBands / VocoderBandBank::lanesPerVec;
+    table.assign((size_t) tableLength * (size_t) groups, Vec::expand(0.0f));
+    
+    juce::dsp::FFT fft(tableOrder);
+    std::vector<float> spectrum((size_t) tableLength * 2);
+    juce::Random phases(0x5eed); // Same tables in every process
+    
+    // White noise in [-1, 1) has variance 1/3, which spreads N/3 of power into
+    // every bin of an N-point transform
+    const auto binMagnitude = std::sqrt((float) tableLength / 3.0f);
+    const auto maxCentre = (float) (sampleRate * 0.45);
+    
+    for (int band = 0; band < numBands; ++band)
+    {
+        const auto centre = juce::jmin(centreFrequencies[band], maxCentre);
+        const auto g = std::tan(juce::MathConstants<double>::pi * centre / sampleRate);
+        const auto inverseQ = 1.0 / resonances[band];
+        
+        std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+        
+        // Every band filters the same noise, as the synthesis bandpasses did,
+        // so overlapping bands still add up coherently
+        phases.setSeed(0x5eed);
+        
+        for (int bin = 1; bin < tableLength / 2; ++bin)
+        {
+            // TPT bandpass response: the analogue prototype s / (s^2 + s/Q + 1)
+            // at the prewarped frequency, with the centre at 1. Its phase
+            // matters as well as its magnitude, since neighbouring bands
+            // partly cancel where they overlap.
+            const auto w = std::tan(juce::MathConstants<double>::pi * bin / tableLength) / g;
+            const auto response = std::complex<double>(0.0, w) / std::complex<double>(1.0 - w * w, w * inverseQ);
+            
+            const auto phase = phases.nextFloat() * juce::MathConstants<float>::twoPi;
+            const auto value = std::complex<float>(response) * std::polar(binMagnitude, phase);
+            const auto re = value.real();
+            const auto im = value.imag();
+            
+            // Mirror the negative frequencies so the inverse gives a real signal
+            spectrum[(size_t) (2 * bin)] = re;
+            spectrum[(size_t) (2 * bin + 1)] = im;
+            spectrum[(size_t) (2 * (tableLength - bin))] = re;
+            spectrum[(size_t) (2 * (tableLength - bin) + 1)] = -im;
+        }
+        
+        fft.performRealOnlyInverseTransform(spectrum.data());
+        
+        const int group = band / VocoderBandBank::lanesPerVec;
+        const auto lane = (size_t) (band % VocoderBandBank::lanesPerVec);
+        
+        for (int row = 0; row < tableLength; ++row)
+            table[(size_t) (row * groups + group)].set(lane, spectrum[(size_t) row]);
+    }
+}
+
+void VocoderCarrierCache::selectLayout(int numBands)
+{
+    jassert (tableSet != nullptr);
+    
+    rows = tableSet->tables[layoutIndex(numBands)].data();
+    numGroups = numBands / VocoderBandBank::lanesPerVec;
+}
+
+void VocoderCarrierCache::jump(ChannelState& state)
+{
+    state.fadeFrom = state.position;
+    state.position = random.nextInt(tableLength);
+    state.fadeIndex = 0;
+    state.samplesToJump = segmentLength;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+#include "VocoderBandBank.h"
+
+// Band-limited noise carriers for the filterbank vocoder, filtered once at
+// prepare time instead of running white noise through a synthesis bandpass per
+// band every sample. Each band's table is white noise shaped in the frequency
+// domain by that band's bandpass response, with the same random phases for
+// every band, so it is stationary and loops without a seam.
+//
+// Tables are stored one row of registers per sample (a register per band
+// group), ready for VocoderBandBank::processSample. Every channel reads the
+// same tables from its own position, and that position jumps somewhere random
+// every segmentLength samples with an equal-power crossfade, so channels stay
+// decorrelated and the loop never repeats.
+//
+// The tables only depend on the sample rate (the band layouts are fixed), so
+// they live in a process-wide store keyed by sample rate and every instance
+// at that rate shares one read-only copy, about 4MB. The store drops a set
+// when the last instance using it lets go. Each instance keeps only its
+// per-channel read state.
+//
+// Read positions are seeded from a random value at construction, so instances
+// differ; setSeed makes them reproducible.
+class VocoderCarrierCache
+{
+public:
+    using Vec = VocoderBandBank::Vec;
+    
+    static constexpr int tableOrder = 14;
+    static constexpr int tableLength = 1 << tableOrder;
+    static constexpr int segmentLength = 4096;
+    static constexpr int fadeLength = 512;
+    static constexpr int maxLayouts = 4; // 4, 8, 16 and 32 bands
+    
+    static_assert (fadeLength < segmentLength && segmentLength < tableLength, "Segments must fit in the table");
+    
+    // Fills centreFrequencies and resonances (bandpass Qs) for numBands bands
+    using LayoutFunction = std::function<void (int numBands, float* centreFrequencies, float* resonances)>;
+    
+    VocoderCarrierCache();
+    
+    // Allocates the read state for numChannels and takes the tables for the
+    // sample rate from the shared store, which builds them with getLayout
+    // (for every band count) if no instance has them yet. getLayout must
+    // give the same layouts in every instance. Not real-time safe.
+    void prepare(double sampleRate, int numChannels, const LayoutFunction& getLayout);
+    
+    // Reseeds the read positions; takes effect at the next prepare
+    void setSeed(juce::int64 seed);
+    
+    // Switches to another band count's tables; safe on the audio thread
+    void selectLayout(int numBands);
+    
+    // The carriers for the channel's next sample, one register per band group
+    inline const Vec* next(int channel);
+
+private:
+    struct ChannelState
+    {
+        int position = 0;
+        int fadeFrom = 0;               // Old position while crossfading away from it
+        int fadeIndex = fadeLength;     // fadeLength when not crossfading
+        int samplesToJump = segmentLength;
+        Vec blended[VocoderBandBank::maxGroups];
+    };
+    
+    // Every band count's tables for one sample rate. They have the same
+    // level as white noise in [-1, 1) through TPT bandpasses with the
+    // layout's settings.
+    struct TableSet
+    {
+        std::vector<Vec> tables[maxLayouts];
+    };
+    
+    // The process-wide store, reached through a juce::SharedResourcePointer.
+    // It holds the sets weakly, so a set lives as long as an instance uses it.
+    class SharedStore
+    {
+    public:
+        std::shared_ptr<const TableSet> get(double sampleRate, const LayoutFunction& getLayout);
+        
+    private:
+        juce::CriticalSection lock;
+        std::map<double, std::weak_ptr<const TableSet>> tableSets;
+    };
+    
+    static int layoutIndex(int numBands);
+    static void buildLayout(std::vector<Vec>& table, double sampleRate, int numBands,
+                            const float* centreFrequencies, const float* resonances);
+    void jump(ChannelState& state);
+    
+    juce::SharedResourcePointer<SharedStore> store;
+    std::shared_ptr<const TableSet> tableSet;
+    std::vector<ChannelState> channels;
+    std::vector<float> fadeIn;           // sin() ramp; read backwards it's the matching fade out
+    juce::Random random;
+    
+    const Vec* rows = nullptr;
+    int numGroups = 0;
+    double sampleRate = 0.0;
+};
+
+inline const VocoderCarrierCache::Vec* VocoderCarrierCache::next(int channel)
+{
+    auto& state = channels[(size_t) channel];
+    
+    if (--state.samplesToJump == 0)
+        jump(state);
+    
+    const Vec* row = rows + state.position * numGroups;
+    state.position = (state.position + 1) & (tableLength - 1);
+    
+    if (state.fadeIndex < fadeLength)
+    {
+        const Vec* oldRow = rows + state.fadeFrom * numGroups;
+        const auto gainIn = Vec::expand(fadeIn[(size_t) state.fadeIndex]);
+        const auto gainOut = Vec::expand(fadeIn[(size_t) (fadeLength - 1 - state.fadeIndex)]);
+        
+        for (int i = 0; i < numGroups; ++i)
+            state.blended[i] = row[i] * gainIn + oldRow[i] * gainOut;
+        
+        state.fadeFrom = (state.fadeFrom + 1) & (tableLength - 1);
+        ++state.fadeIndex;
+        row = state.blended;
+    }
+    
+    return row;
+}
@@ -0,0 +1,23 @@
+#include "VocoderEngine.h"
+#include "VocoderFilterbank.h"
+#include "SpectralVocoder.h"
+#include "VocoderSimple.h"
+#include "VocoderGated.h"
+
+juce::StringArray VocoderEngine::getTypeNames()
+{
+    return { "Filterbank", "Spectral", "Simple", "Gated" };
+}
+
+std::unique_ptr<VocoderEngine> VocoderEngine::create(Type type, NoiseEngine& noiseSource)
+{
+    switch (type)
+    {
+        case Type::spectral:    return std::make_unique<SpectralVocoder>(noiseSource);
+        case Type::simple:      return std::make_unique<SimpleVocoder>(noiseSource);
+        case Type::gated:       return std::make_unique<GatedVocoder>(noiseSource);
+        case Type::filterbank:  break;
+    }
+    
+    return std::make_unique<FilterbankVocoder>();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <memory>
+
+class NoiseEngine;
+
+// Common interface for the vocoders. The processor owns only the engine the
+// "vocoderEngine" parameter selects, so unused engines allocate nothing.
+class VocoderEngine
+{
+public:
+    // The "vocoderEngine" parameter's choices, in order
+    enum class Type
+    {
+        filterbank,
+        spectral,
+        simple,
+        gated
+    };
+    
+    static juce::StringArray getTypeNames();
+    
+    // Settings for one block. gain, release and brightness are 0-1. Only the
+    // filterbank uses numBands (4, 8, 16 or 32) and envelopeDecimation
+    // (samples per envelope follower step, 0 for automatic).
+    struct Parameters
+    {
+        float gain = 0.0f;
+        float release = 0.5f;
+        float brightness = 0.5f;
+        int numBands = 4;
+        int envelopeDecimation = 0;
+    };
+    
+    // Engines that need white noise draw it from noiseSource, which must
+    // outlive them and be prepared for at least as many channels
+    static std::unique_ptr<VocoderEngine> create(Type type, NoiseEngine& noiseSource);
+    
+    virtual ~VocoderEngine() = default;
+    
+    // Allocates everything; not real-time safe
+    virtual void prepare(double sampleRate, int numChannels) = 0;
+    virtual void reset() = 0;
+    
+    // Writes the vocoded noise for input's channels into output, replacing it.
+    // Channels beyond those prepared are left alone.
+    virtual void process(const juce::AudioBuffer<float>& input,
+                         juce::AudioBuffer<float>& output,
+                         const Parameters& parameters) = 0;
+};
@@ -1,235 +1,202 @@
 // VocoderFilterbank.cpp - Filterbank vocoder implementation (more stable than FFT)
 
-#include "PluginProcessor.h"
+#include "VocoderFilterbank.h"
+#include <algorithm>
 #include <cmath>
+#include <complex>
 
-// Simple envelope follower class
-class EnvelopeFollower
+void FilterbankVocoder::prepare(double newSampleRate, int numChannels)
 {
-public:
-    EnvelopeFollower() = default;
+    sampleRate = newSampleRate;
+    bands.prepare(sampleRate, numChannels);
+    setEnvelopeDecimation(envelopeDecimation); // Automatic depends on the rate
+    bands.setAttackMs(0.5f);
     
-    void setSampleRate(float sr) 
-    { 
-        sampleRate = sr; 
-        updateCoefficients();
-    }
+    // Carrier tables for every band count, so switching never allocates.
+    // They are shared with every other instance at this sample rate and only
+    // built when none has them yet.
+    carriers.prepare(sampleRate, numChannels, [] (int count, float* centres, float* resonances)
+    {
+        const auto layout = makeLayout(count);
+        std::copy(layout.centres, layout.centres + count, centres);
+        std::copy(layout.synthesisQ, layout.synthesisQ + count, resonances);
+    });
     
-    void setAttackMs(float ms) 
-    { 
-        attackMs = ms; 
-        updateCoefficients();
-    }
+    setNumBands(numBands, true); // Coefficients depend on the sample rate
     
-    void setReleaseMs(float ms) 
-    { 
-        releaseMs = ms; 
-        updateCoefficients();
-    }
+    channels.resize((size_t) numChannels);
+    reset();
+}
+
+FilterbankVocoder::Layout FilterbankVocoder::makeLayout(int numBands)
+{
+    Layout layout;
+    layout.numBands = numBands;
     
-    float process(float input)
+    // Octaves between neighbouring bands; the 4-band voicing is one octave apart,
+    // so Q scales up as the bands get closer to keep them just touching
+    const float rangeOctaves = std::log2(highestCentre / lowestCentre);
+    const float spacingOctaves = rangeOctaves / (float) (numBands - 1);
+    
+    // Each bandpass peaks at its Q, and overlapping bands filter the same noise
+    // so they add up coherently: scale by spacing and band count to keep the
+    // overall level close to the 4-band voicing
+    const float levelScale = spacingOctaves * (float) numVoicingPoints / (float) numBands;
+    
+    for (int band = 0; band < numBands; ++band)
     {
-        float rectified = std::abs(input);
+        const float position = (float) band / (float) (numBands - 1);
         
-        if (rectified > envelope)
-            envelope += (rectified - envelope) * attackCoeff;
-        else
-            envelope += (rectified - envelope) * releaseCoeff;
-            
-        return envelope;
+        // Interpolate the voicing tables at this band's position
+        const float voicingPos = position * (float) (numVoicingPoints - 1);
+        const int index = juce::jmin((int) voicingPos, numVoicingPoints - 2);
+        const float frac = voicingPos - (float) index;
+        auto voicing = [index, frac] (const float* table)
+        {
+            return table[index] + (table[index + 1] - table[index]) * frac;
+        };
+        
+        layout.centres[band] = lowestCentre * std::exp2(position * rangeOctaves);
+        layout.analysisQ[band] = voicing(voicingBandwidths) / spacingOctaves;
+        layout.synthesisQ[band] = layout.analysisQ[band] * 0.7f; // Lower Q for wider bands
+        layout.warmGains[band] = voicing(voicingWarmGains) * levelScale;
+        layout.brightGains[band] = voicing(voicingBrightGains) * levelScale;
     }
     
-    void reset() { envelope = 0.0f; }
+    return layout;
+}
+
+void FilterbankVocoder::setNumBands(int newNumBands, bool force)
+{
+    newNumBands = juce::jlimit(VocoderBandBank::lanesPerVec, maxBands, newNumBands);
+    
+    if (newNumBands == numBands && ! force)
+        return;
     
-private:
-    float envelope = 0.0f;
-    float sampleRate = 44100.0f;
-    float attackMs = 1.0f;
-    float releaseMs = 10.0f;
-    float attackCoeff = 0.0f;
-    float releaseCoeff = 0.0f;
+    numBands = newNumBands;
     
-    void updateCoefficients()
-    {
-        attackCoeff = 1.0f - std::exp(-1.0f / (attackMs * 0.001f * sampleRate));
-        releaseCoeff = 1.0f - std::exp(-1.0f / (releaseMs * 0.001f * sampleRate));
-    }
-};
+    const auto layout = makeLayout(numBands);
+    std::copy(layout.centres, layout.centres + numBands, centres);
+    std::copy(layout.warmGains, layout.warmGains + numBands, warmGains);
+    std::copy(layout.brightGains, layout.brightGains + numBands, brightGains);
+    
+    bands.setBands(numBands, layout.centres, layout.analysisQ);
+    carriers.selectLayout(numBands);
+    carrierShapeBrightness = -1.0f;
+}
 
-// Simple white noise generator with smoothing
-class SmoothNoiseGenerator
+void FilterbankVocoder::setEnvelopeDecimation(int factor)
 {
-public:
-    void reset() 
-    { 
-        z1 = 0.0f;
-        z2 = 0.0f;
-        z3 = 0.0f;
-    }
+    envelopeDecimation = juce::jmax(0, factor);
+    bands.setEnvelopeDecimation(envelopeDecimation > 0 ? envelopeDecimation
+                                                      : juce::roundToInt(sampleRate / defaultEnvelopeControlRate));
+}
+
+void FilterbankVocoder::updateCarrierShape(float brightness)
+{
+    if (brightness == carrierShapeBrightness)
+        return;
+    
+    carrierShapeBrightness = brightness;
     
-    float process(juce::Random& random)
+    // The old per-sample noise source: a mix of lowpassed and high-passed
+    // independent white noises, both set by brightness
+    const float hpCutoff = 0.05f + brightness * 0.25f; // More HP when brighter
+    const float hpMix = 0.5f + brightness * 0.4f;      // 50-90% based on brightness
+    const float smoothCutoff = 0.15f;
+    
+    auto onePole = [] (float cutoff, std::complex<float> zInverse)
     {
-        // Generate white noise
-        float white = (random.nextFloat() - 0.5f) * 2.0f;
-        
-        // Apply 3-pole lowpass filter for smoother noise
-        // This removes harsh high frequencies
-        const float cutoff = 0.15f; // Adjust for smoothness
+        return cutoff / (1.0f - (1.0f - cutoff) * zInverse);
+    };
+    
+    // Its amplitude response at each band centre, relative to plain white noise
+    for (int band = 0; band < numBands; ++band)
+    {
+        const auto w = juce::MathConstants<float>::twoPi * juce::jmin(centres[band], (float) (sampleRate * 0.45)) / (float) sampleRate;
+        const auto zInverse = std::polar(1.0f, -w);
         
-        z1 += (white - z1) * cutoff;
-        z2 += (z1 - z2) * cutoff;
-        z3 += (z2 - z3) * cutoff;
+        const auto smoothPole = onePole(smoothCutoff, zInverse);
+        const auto smooth = smoothPole * smoothPole * smoothPole * 0.7f + 0.3f;
+        const auto highpassed = 1.0f - onePole(hpCutoff, zInverse);
         
-        // Mix filtered and original for controlled brightness
-        return z3 * 0.7f + white * 0.3f;
+        carrierShape[band] = std::sqrt(std::norm(smooth) * (1.0f - hpMix) * (1.0f - hpMix)
+                                       + std::norm(highpassed) * hpMix * hpMix);
     }
-    
-private:
-    float z1 = 0.0f, z2 = 0.0f, z3 = 0.0f;
-};
+}
 
-// Filterbank vocoder implementation
-void BuildUpVerbAudioProcessor::processVocoderFilterbank(juce::AudioBuffer<float>& buffer, 
-                                                        juce::AudioBuffer<float>& noiseBuffer,
-                                                        float vocoderGain,
-                                                        float vocoderRelease,
-                                                        float vocoderBrightness)
+void FilterbankVocoder::reset()
 {
-    const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
-    const float sampleRate = getSampleRate();
-    
-    // 4 bands - High-mids + crispy highs
-    const float centerFreqs[4] = {1500.0f, 3000.0f, 6000.0f, 12000.0f};
-    const float bandwidths[4] = {1.2f, 1.0f, 0.8f, 0.8f}; // Wider low bands for body
-    
-    // Static filters and envelopes (should be member variables in real implementation)
-    static juce::dsp::StateVariableTPTFilter<float> analysisBands[2][4]; // Stereo
-    static juce::dsp::StateVariableTPTFilter<float> synthesisBands[2][4]; // Stereo
-    static EnvelopeFollower envelopes[2][4]; // Stereo
-    static SmoothNoiseGenerator noiseGen[2]; // Stereo
-    static float outputSmooth[2] = {0.0f, 0.0f}; // Output smoothing
-    static bool initialized = false;
-    
-    // Initialize on first use
-    if (!initialized)
+    bands.reset();
+    
+    for (auto& state : channels)
     {
-        juce::dsp::ProcessSpec spec;
-        spec.sampleRate = sampleRate;
-        spec.maximumBlockSize = 512;
-        spec.numChannels = 1;
-        
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            for (int i = 0; i < 4; ++i)
-            {
-                analysisBands[ch][i].prepare(spec);
-                analysisBands[ch][i].setType(juce::dsp::StateVariableTPTFilterType::bandpass);
-                analysisBands[ch][i].setCutoffFrequency(centerFreqs[i]);
-                analysisBands[ch][i].setResonance(bandwidths[i]);
-                
-                synthesisBands[ch][i].prepare(spec);
-                synthesisBands[ch][i].setType(juce::dsp::StateVariableTPTFilterType::bandpass);
-                synthesisBands[ch][i].setCutoffFrequency(centerFreqs[i]);
-                synthesisBands[ch][i].setResonance(bandwidths[i] * 0.7f); // Lower Q for wider bands
-                
-                envelopes[ch][i].setSampleRate(sampleRate);
-                envelopes[ch][i].setAttackMs(0.5f);
-                envelopes[ch][i].setReleaseMs(10.0f + vocoderRelease * 990.0f);
-            }
-            noiseGen[ch].reset();
-        }
-        initialized = true;
+        state.outputSmooth = 0.0f;
+        state.highShelf1 = 0.0f;
+        state.highShelf2 = 0.0f;
     }
+}
+
+void FilterbankVocoder::process(const juce::AudioBuffer<float>& buffer,
+                                juce::AudioBuffer<float>& noiseBuffer,
+                                const Parameters& parameters)
+{
+    using Vec = VocoderBandBank::Vec;
+    
+    const int numSamples = buffer.getNumSamples();
+    // Channels beyond what prepare saw have no state to run with
+    const int numChannels = juce::jmin(buffer.getNumChannels(), noiseBuffer.getNumChannels(), (int) channels.size());
+    const float vocoderGain = parameters.gain;
+    const float vocoderBrightness = parameters.brightness;
+    
+    setNumBands(parameters.numBands);
+    setEnvelopeDecimation(parameters.envelopeDecimation);
     
-    // Update release times
-    for (int ch = 0; ch < numChannels; ++ch)
+    // Update release time (only recalculated when it changes)
+    bands.setReleaseMs(10.0f + parameters.release * 990.0f);
+    
+    // Brightness morphs every band between its warm and bright gain, and
+    // shapes the carriers
+    updateCarrierShape(vocoderBrightness);
+    
+    Vec bandGains[VocoderBandBank::maxGroups];
+    for (int i = 0; i < bands.getNumGroups(); ++i)
     {
-        for (int i = 0; i < 4; ++i)
-        {
-            envelopes[ch][i].setReleaseMs(10.0f + vocoderRelease * 990.0f);
-        }
+        const int offset = i * VocoderBandBank::lanesPerVec;
+        bandGains[i] = (Vec::fromRawArray(warmGains + offset) * (1.0f - vocoderBrightness)
+                      + Vec::fromRawArray(brightGains + offset) * vocoderBrightness)
+                     * Vec::fromRawArray(carrierShape + offset);
     }
     
+    const float emphasisAmount = vocoderBrightness * 1.2f;    // 0-120% emphasis
+    
     // Process each channel
     for (int channel = 0; channel < numChannels; ++channel)
     {
         const float* inputData = buffer.getReadPointer(channel);
         float* outputData = noiseBuffer.getWritePointer(channel);
+        auto& state = channels[(size_t) channel];
         
-        // Process each sample
         for (int sample = 0; sample < numSamples; ++sample)
         {
-            float input = inputData[sample];
-            
-            // Analyze input through filter bands and get envelopes
-            float bandEnvelopes[4];
-            for (int band = 0; band < 4; ++band)
-            {
-                // Filter input signal through analysis band
-                float filtered = analysisBands[channel][band].processSample(0, input);
-                
-                // Get envelope of filtered signal
-                bandEnvelopes[band] = envelopes[channel][band].process(filtered);
-            }
-            
-            // Generate ONE smooth noise source
-            float noise = noiseGen[channel].process(random);
-            
-            // MOSTLY raw white noise (90% mix) for maximum brightness
-            float rawNoise = (random.nextFloat() - 0.5f) * 2.0f;
-            
-            // Variable high-pass based on brightness
-            static float hpState[2] = {0.0f, 0.0f};
-            float hpCutoff = 0.05f + vocoderBrightness * 0.25f; // More HP when brighter
-            hpState[channel] += (rawNoise - hpState[channel]) * hpCutoff;
-            float highpassedNoise = rawNoise - hpState[channel];
-            
-            // More high-passed noise when brighter
-            float hpMix = 0.5f + vocoderBrightness * 0.4f; // 50-90% based on brightness
-            noise = noise * (1.0f - hpMix) + highpassedNoise * hpMix;
-            
-            // Filter the SAME noise through all synthesis bands and modulate
-            float output = 0.0f;
-            for (int band = 0; band < 4; ++band)
-            {
-                // Filter the noise through synthesis band
-                float filteredNoise = synthesisBands[channel][band].processSample(0, noise);
-                
-                // Modulate filtered noise with the envelope from analysis
-                // Dynamic gain based on brightness parameter
-                float bandGain = 1.0f;
-                
-                // Brightness morphs between warm and bright settings
-                if (band == 0) // 1.5kHz
-                    bandGain = 4.0f * (1.0f - vocoderBrightness) + 0.5f * vocoderBrightness;
-                if (band == 1) // 3kHz
-                    bandGain = 4.0f * (1.0f - vocoderBrightness) + 1.0f * vocoderBrightness;
-                if (band == 2) // 6kHz
-                    bandGain = 3.0f * (1.0f - vocoderBrightness) + 10.0f * vocoderBrightness;
-                if (band == 3) // 12kHz
-                    bandGain = 2.0f * (1.0f - vocoderBrightness) + 20.0f * vocoderBrightness;
-                    
-                output += filteredNoise * bandEnvelopes[band] * bandGain;
-            }
+            // Analyse the input and modulate every band's carrier by its
+            // envelope at once
+            float output = bands.processSample(channel, inputData[sample], carriers.next(channel), bandGains);
             
             // Apply overall gain and extra output smoothing
             const float smoothCoeff = 0.95f; // Adjust for more/less smoothing
-            outputSmooth[channel] += (output - outputSmooth[channel]) * (1.0f - smoothCoeff);
+            state.outputSmooth += (output - state.outputSmooth) * (1.0f - smoothCoeff);
             // Multiple high-frequency emphasis stages
-            static float highShelf1[2] = {0.0f, 0.0f};
-            static float highShelf2[2] = {0.0f, 0.0f};
             
             // First emphasis stage
-            float brightened = outputSmooth[channel] + (outputSmooth[channel] - highShelf1[channel]) * 1.0f;
-            highShelf1[channel] = outputSmooth[channel];
+            float brightened = state.outputSmooth + (state.outputSmooth - state.highShelf1) * 1.0f;
+            state.highShelf1 = state.outputSmooth;
             
             // Second emphasis stage - variable based on brightness
-            float emphasisAmount = vocoderBrightness * 1.2f; // 0-120% emphasis
-            float superBright = brightened + (brightened - highShelf2[channel]) * emphasisAmount;
-            highShelf2[channel] = brightened;
+            float superBright = brightened + (brightened - state.highShelf2) * emphasisAmount;
+            state.highShelf2 = brightened;
             
             outputData[sample] = superBright * vocoderGain * 2.0f;
         }
     }
-}
\ No newline at end of file
+}
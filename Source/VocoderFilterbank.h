@@ -0,0 +1,96 @@
+#pragma once
+
+#include "VocoderEngine.h"
+#include "VocoderBandBank.h"
+#include "VocoderCarrierCache.h"
+#include <vector>
+
+// Filterbank vocoder: the input's envelope in each band modulates a
+// band-limited noise carrier in the same band. Per-band work runs in a
+// VocoderBandBank; the carriers come from a VocoderCarrierCache.
+class FilterbankVocoder : public VocoderEngine
+{
+public:
+    static constexpr int maxBands = VocoderBandBank::maxBands;
+    
+    // Band centres are log-spaced over this range - High-mids + crispy highs
+    static constexpr float lowestCentre = 1500.0f;
+    static constexpr float highestCentre = 12000.0f;
+    
+    // The original 4-band voicing (one band per octave: 1.5, 3, 6, 12kHz).
+    // Other band counts interpolate it across the range by log frequency.
+    static constexpr int numVoicingPoints = 4;
+    static constexpr float voicingBandwidths[numVoicingPoints] = {1.2f, 1.0f, 0.8f, 0.8f}; // Wider low bands for body
+    static constexpr float voicingWarmGains[numVoicingPoints] = {4.0f, 4.0f, 3.0f, 2.0f};
+    static constexpr float voicingBrightGains[numVoicingPoints] = {0.5f, 1.0f, 10.0f, 20.0f};
+    
+    // With automatic decimation the envelope followers run at about this
+    // rate whatever the sample rate. It can't go much lower: a 0.5ms attack
+    // on bands up to 12kHz follows the rectified ripple, and that ripple is
+    // part of the vocoder's sound.
+    static constexpr double defaultEnvelopeControlRate = 48000.0;
+    
+    // Centres, resonances and gains of every band for one band count
+    struct Layout
+    {
+        int numBands = 0;
+        float centres[maxBands], analysisQ[maxBands], synthesisQ[maxBands];
+        float warmGains[maxBands], brightGains[maxBands];
+    };
+    
+    static Layout makeLayout(int numBands);
+    
+    // prepare keeps the current band count
+    void prepare(double sampleRate, int numChannels) override;
+    void reset() override;
+    void process(const juce::AudioBuffer<float>& input,
+                 juce::AudioBuffer<float>& output,
+                 const Parameters& parameters) override;
+    
+    // 4, 8, 16 or 32. Recomputes the band layout without allocating, so it can
+    // be called from the audio thread; does nothing if the count is unchanged.
+    void setNumBands(int newNumBands, bool force = false);
+    
+    // Samples per envelope follower step, or 0 for automatic (about
+    // defaultEnvelopeControlRate). Doesn't allocate; process() applies
+    // Parameters::envelopeDecimation through this.
+    void setEnvelopeDecimation(int factor);
+    int getEnvelopeDecimation() const { return bands.getEnvelopeDecimation(); }
+    
+    // Makes the carriers' read positions reproducible; call before prepare
+    void setCarrierSeed(juce::int64 seed) { carriers.setSeed(seed); }
+
+private:
+    // Updates carrierShape for a brightness of 0-1 if it has changed
+    void updateCarrierShape(float brightness);
+    
+    // Brightness morphs each band's gain between these warm and bright
+    // settings (aligned so they load straight into SIMD registers)
+    int numBands = 4;
+    alignas (16) float warmGains[maxBands] = {};
+    alignas (16) float brightGains[maxBands] = {};
+    float centres[maxBands] = {};
+    
+    // The carriers stand in for white noise that was shaped by brightness
+    // before the synthesis bandpass; these per-band gains put that shaping
+    // back, recomputed when brightness or the band count changes
+    alignas (16) float carrierShape[maxBands] = {};
+    float carrierShapeBrightness = -1.0f;
+    double sampleRate = 44100.0;
+    int envelopeDecimation = 0;  // As set; 0 is automatic
+    
+    // Analysis filters and envelopes for every band and channel
+    VocoderBandBank bands;
+    
+    // Pre-filtered noise carriers for every band count
+    VocoderCarrierCache carriers;
+    
+    struct Channel
+    {
+        float outputSmooth = 0.0f;  // Output smoothing
+        float highShelf1 = 0.0f;    // High-frequency emphasis stages
+        float highShelf2 = 0.0f;
+    };
+    
+    std::vector<Channel> channels;
+};
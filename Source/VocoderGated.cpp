@@ -1,20 +1,27 @@
 // VocoderGated.cpp - Gate-based vocoder (no envelope following)
 
-#include "PluginProcessor.h"
+#include "VocoderGated.h"
+#include "NoiseEngine.h"
 #include <cmath>
 
-void BuildUpVerbAudioProcessor::processVocoderGated(juce::AudioBuffer<float>& buffer, 
-                                                   juce::AudioBuffer<float>& noiseBuffer,
-                                                   float vocoderGain,
-                                                   float vocoderRelease,
-                                                   float vocoderBrightness)
+void GatedVocoder::prepare(double, int numChannels)
+{
+    channels.assign((size_t) numChannels, Channel());
+}
+
+void GatedVocoder::reset()
+{
+    std::fill(channels.begin(), channels.end(), Channel());
+}
+
+void GatedVocoder::process(const juce::AudioBuffer<float>& buffer,
+                           juce::AudioBuffer<float>& noiseBuffer,
+                           const Parameters& parameters)
 {
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
-    
-    // Static gate state
-    static float gateLevel[2] = {0.0f, 0.0f};
-    static float noiseLevel[2] = {0.0f, 0.0f};
+    // Channels beyond what prepare saw have no state to run with
+    const int numChannels = juce::jmin(buffer.getNumChannels(), noiseBuffer.getNumChannels(), (int) channels.size());
+    const float vocoderGain = parameters.gain;
     
     // Gate threshold
     const float threshold = 0.001f; // -60dB
@@ -24,6 +31,10 @@ void BuildUpVerbAudioProcessor::processVocoderGated(juce::AudioBuffer<float>& bu
     {
         const float* inputData = buffer.getReadPointer(channel);
         float* outputData = noiseBuffer.getWritePointer(channel);
+        auto& state = channels[(size_t) channel];
+        
+        // Generate white noise for the whole block, then shape it in place
+        noiseEngine.fill(channel, outputData, numSamples);
         
         for (int sample = 0; sample < numSamples; ++sample)
         {
@@ -33,21 +44,16 @@ void BuildUpVerbAudioProcessor::processVocoderGated(juce::AudioBuffer<float>& bu
             
             // Smooth the gate transition
             const float gateSmooth = 0.95f; // Heavy smoothing
-            gateLevel[channel] += (targetGate - gateLevel[channel]) * (1.0f - gateSmooth);
+            state.gateLevel += (targetGate - state.gateLevel) * (1.0f - gateSmooth);
             
             // Generate smooth noise (lowpass filtered white noise)
-            static float noiseZ1[2] = {0.0f, 0.0f};
-            float white = (random.nextFloat() - 0.5f) * 2.0f;
-            noiseZ1[channel] += (white - noiseZ1[channel]) * 0.1f; // Lowpass
+            state.noiseZ1 += (outputData[sample] - state.noiseZ1) * 0.1f; // Lowpass
             
-            // Apply gate to noise with additional smoothing
-            float targetNoiseLevel = noiseZ1[channel] * gateLevel[channel];
+            // Level the gated noise plays at, with additional smoothing
             const float outputSmooth = 0.99f; // Very heavy output smoothing
-            noiseLevel[channel] += (targetNoiseLevel - noiseLevel[channel]) * (1.0f - outputSmooth);
+            state.noiseLevel += (state.gateLevel - state.noiseLevel) * (1.0f - outputSmooth);
             
-            // TEST: Output actual WHITE NOISE at constant level
-            float whiteNoise = (random.nextFloat() - 0.5f) * 2.0f;
-            outputData[sample] = whiteNoise * 0.2f; // Constant amplitude white noise
+            outputData[sample] = state.noiseZ1 * state.noiseLevel * vocoderGain * 2.0f;
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "VocoderEngine.h"
+#include <vector>
+
+// Gate-based vocoder (no envelope following): lowpassed noise switched on
+// whenever the input is above -60dB, with the level smoothed in and out
+class GatedVocoder : public VocoderEngine
+{
+public:
+    explicit GatedVocoder(NoiseEngine& noiseSource) : noiseEngine(noiseSource) {}
+    
+    void prepare(double sampleRate, int numChannels) override;
+    void reset() override;
+    void process(const juce::AudioBuffer<float>& input,
+                 juce::AudioBuffer<float>& output,
+                 const Parameters& parameters) override;
+
+private:
+    struct Channel
+    {
+        float gateLevel = 0.0f;     // Smoothed gate, 0-1
+        float noiseLevel = 0.0f;    // Level the noise plays at, following the gate
+        float noiseZ1 = 0.0f;       // Lowpassed noise
+    };
+    
+    NoiseEngine& noiseEngine;
+    std::vector<Channel> channels;
+};
@@ -1,20 +1,28 @@
 // VocoderSimple.cpp - 4-band vocoder like Ableton
 
-#include "PluginProcessor.h"
-#include <juce_dsp/juce_dsp.h>
+#include "VocoderSimple.h"
+#include "NoiseEngine.h"
 #include <cmath>
 
-void BuildUpVerbAudioProcessor::processVocoderSimple(juce::AudioBuffer<float>& buffer, 
-                                                    juce::AudioBuffer<float>& noiseBuffer,
-                                                    float vocoderGain,
-                                                    float vocoderRelease,
-                                                    float vocoderBrightness)
+void SimpleVocoder::prepare(double, int numChannels)
+{
+    envelope.assign((size_t) numChannels, 0.0f);
+}
+
+void SimpleVocoder::reset()
+{
+    std::fill(envelope.begin(), envelope.end(), 0.0f);
+}
+
+void SimpleVocoder::process(const juce::AudioBuffer<float>& buffer,
+                            juce::AudioBuffer<float>& noiseBuffer,
+                            const Parameters& parameters)
 {
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
-    
-    // Static envelope follower state
-    static float envelope[2] = {0.0f, 0.0f};
+    // Channels beyond what prepare saw have no state to run with
+    const int numChannels = juce::jmin(buffer.getNumChannels(), noiseBuffer.getNumChannels(), (int) envelope.size());
+    const float vocoderGain = parameters.gain;
+    const float vocoderRelease = parameters.release;
     
     // Smoother coefficients to prevent ringing
     float attackCoeff = 0.01f;  // Much smoother attack to prevent ringing
@@ -25,6 +33,10 @@ void BuildUpVerbAudioProcessor::processVocoderSimple(juce::AudioBuffer<float>& b
     {
         const float* inputData = buffer.getReadPointer(channel);
         float* outputData = noiseBuffer.getWritePointer(channel);
+        float& channelEnvelope = envelope[(size_t) channel];
+        
+        // Generate simple white noise for the whole block, then shape it in place
+        noiseEngine.fill(channel, outputData, numSamples);
         
         for (int sample = 0; sample < numSamples; ++sample)
         {
@@ -32,16 +44,13 @@ void BuildUpVerbAudioProcessor::processVocoderSimple(juce::AudioBuffer<float>& b
             float inputMag = std::abs(inputData[sample]);
             
             // Simple envelope follower
-            if (inputMag > envelope[channel])
-                envelope[channel] += (inputMag - envelope[channel]) * attackCoeff;
+            if (inputMag > channelEnvelope)
+                channelEnvelope += (inputMag - channelEnvelope) * attackCoeff;
             else
-                envelope[channel] += (inputMag - envelope[channel]) * releaseCoeff;
-            
-            // Generate simple white noise
-            float noise = (random.nextFloat() - 0.5f) * 2.0f;
+                channelEnvelope += (inputMag - channelEnvelope) * releaseCoeff;
             
             // Apply envelope to noise with smoothing
-            outputData[sample] = noise * envelope[channel] * vocoderGain * 2.0f;
+            outputData[sample] = outputData[sample] * channelEnvelope * vocoderGain * 2.0f;
         }
     }
 }
\ No newline at end of file
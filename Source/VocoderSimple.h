@@ -0,0 +1,22 @@
+#pragma once
+
+#include "VocoderEngine.h"
+#include <vector>
+
+// Broadband vocoder: white noise scaled by the input's envelope, with no
+// bands - the cheapest engine
+class SimpleVocoder : public VocoderEngine
+{
+public:
+    explicit SimpleVocoder(NoiseEngine& noiseSource) : noiseEngine(noiseSource) {}
+    
+    void prepare(double sampleRate, int numChannels) override;
+    void reset() override;
+    void process(const juce::AudioBuffer<float>& input,
+                 juce::AudioBuffer<float>& output,
+                 const Parameters& parameters) override;
+
+private:
+    NoiseEngine& noiseEngine;
+    std::vector<float> envelope;
+};
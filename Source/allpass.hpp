@@ -14,6 +14,7 @@ public:
 					allpass();
 			void	setbuffer(float *buf, int size);
 	inline  float	process(float inp);
+	inline  void	processblock(float *inout, int numsamples);
 			void	mute();
 			void	setfeedback(float val);
 			float	getfeedback();
@@ -43,6 +44,34 @@ inline float allpass::process(float input)
 	return output;
 }
 
+// Block version, in place. No undenormalise here - the
+// block path in revmodel runs with FTZ/DAZ enabled.
+
+inline void allpass::processblock(float *inout, int numsamples)
+{
+	while(numsamples > 0)
+	{
+		// Run up to the end of the delay line without wrap checks
+		int segment = bufsize - bufidx;
+		if (segment > numsamples) segment = numsamples;
+
+		float *line = buffer + bufidx;
+		for(int i=0; i<segment; i++)
+		{
+			float bufout = line[i];
+			float input = inout[i];
+			inout[i] = -input + bufout;
+			line[i] = input + (bufout*feedback);
+		}
+
+		bufidx += segment;
+		if(bufidx>=bufsize) bufidx = 0;
+
+		inout += segment;
+		numsamples -= segment;
+	}
+}
+
 #endif//_allpass
 
 //ends
\ No newline at end of file
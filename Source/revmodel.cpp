@@ -8,31 +8,14 @@
 
 revmodel::revmodel()
 {
-	// Tie the components to their buffers
-	combL[0].setbuffer(bufcombL1,combtuningL1);
-	combR[0].setbuffer(bufcombR1,combtuningR1);
-	combL[1].setbuffer(bufcombL2,combtuningL2);
-	combR[1].setbuffer(bufcombR2,combtuningR2);
-	combL[2].setbuffer(bufcombL3,combtuningL3);
-	combR[2].setbuffer(bufcombR3,combtuningR3);
-	combL[3].setbuffer(bufcombL4,combtuningL4);
-	combR[3].setbuffer(bufcombR4,combtuningR4);
-	combL[4].setbuffer(bufcombL5,combtuningL5);
-	combR[4].setbuffer(bufcombR5,combtuningR5);
-	combL[5].setbuffer(bufcombL6,combtuningL6);
-	combR[5].setbuffer(bufcombR6,combtuningR6);
-	combL[6].setbuffer(bufcombL7,combtuningL7);
-	combR[6].setbuffer(bufcombR7,combtuningR7);
-	combL[7].setbuffer(bufcombL8,combtuningL8);
-	combR[7].setbuffer(bufcombR8,combtuningR8);
-	allpassL[0].setbuffer(bufallpassL1,allpasstuningL1);
-	allpassR[0].setbuffer(bufallpassR1,allpasstuningR1);
-	allpassL[1].setbuffer(bufallpassL2,allpasstuningL2);
-	allpassR[1].setbuffer(bufallpassR2,allpasstuningR2);
-	allpassL[2].setbuffer(bufallpassL3,allpasstuningL3);
-	allpassR[2].setbuffer(bufallpassR3,allpasstuningR3);
-	allpassL[3].setbuffer(bufallpassL4,allpasstuningL4);
-	allpassR[3].setbuffer(bufallpassR4,allpasstuningR4);
+	delaymemorysize = 0;
+	samplerate = 0;
+	gain = roomsize = roomsize1 = damp = damp1 = 0;
+	wet = wet1 = wet2 = dry = width = mode = 0;
+	dirty = true;
+
+	// Allocates and ties the components to their buffers
+	setsamplerate(tuningsamplerate);
 
 	// Set default values
 	allpassL[0].setfeedback(0.5f);
@@ -49,22 +32,110 @@ revmodel::revmodel()
 	setdamp(initialdamp);
 	setwidth(initialwidth);
 	setmode(initialmode);
+	update();
+	combs.skipRamp();
 
 	// Buffer will be full of rubbish - so we MUST mute them
 	mute();
 }
 
-void revmodel::mute()
+void revmodel::setsamplerate(double newsamplerate)
 {
-	if (getmode() >= freezemode)
-		return;
+	static const int combtuningL[numcombs] = { combtuningL1, combtuningL2, combtuningL3, combtuningL4,
+	                                           combtuningL5, combtuningL6, combtuningL7, combtuningL8 };
+	static const int combtuningR[numcombs] = { combtuningR1, combtuningR2, combtuningR3, combtuningR4,
+	                                           combtuningR5, combtuningR6, combtuningR7, combtuningR8 };
+	static const int allpasstuningL[numallpasses] = { allpasstuningL1, allpasstuningL2, allpasstuningL3, allpasstuningL4 };
+	static const int allpasstuningR[numallpasses] = { allpasstuningR1, allpasstuningR2, allpasstuningR3, allpasstuningR4 };
+
+	// Each line is padded to a whole number of cache lines
+	const int alignfloats = cachelinebytes / (int) sizeof(float);
+	const double scale = newsamplerate / tuningsamplerate;
+
+	int combsizeL[numcombs], combsizeR[numcombs];
+	int allpasssizeL[numallpasses], allpasssizeR[numallpasses];
+	size_t totalfloats = 0;
+
+	auto scaled = [&](int tuning, int &size)
+	{
+		size = juce::jmax(1, juce::roundToInt(tuning * scale));
+		totalfloats += (size_t) ((size + alignfloats - 1) / alignfloats) * alignfloats;
+	};
 
 	for (int i=0;i<numcombs;i++)
 	{
-		combL[i].mute();
-		combR[i].mute();
+		scaled(combtuningL[i], combsizeL[i]);
+		scaled(combtuningR[i], combsizeR[i]);
 	}
 	for (int i=0;i<numallpasses;i++)
+	{
+		scaled(allpasstuningL[i], allpasssizeL[i]);
+		scaled(allpasstuningR[i], allpasssizeR[i]);
+	}
+
+	samplerate = newsamplerate;
+
+	// Feedback/damping changes glide over 10ms
+	combs.setRampLength(juce::roundToInt(samplerate * 0.01));
+
+	// One zeroed block, with room to align the start to a cache line
+	delaymemory.allocate(totalfloats + (size_t) alignfloats, true);
+	delaymemorysize = (totalfloats + (size_t) alignfloats) * sizeof(float);
+
+	float *next = delaymemory.get();
+	while (((size_t) next % cachelinebytes) != 0)
+		next++;
+
+	auto take = [&](int size)
+	{
+		float *buf = next;
+		next += ((size + alignfloats - 1) / alignfloats) * alignfloats;
+		return buf;
+	};
+
+	for (int i=0;i<numcombs;i++)
+		combs.setBuffer(i, take(combsizeL[i]), combsizeL[i]);
+	for (int i=0;i<numcombs;i++)
+		combs.setBuffer(numcombs+i, take(combsizeR[i]), combsizeR[i]);
+	for (int i=0;i<numallpasses;i++)
+	{
+		allpassL[i].setbuffer(take(allpasssizeL[i]), allpasssizeL[i]);
+		allpassR[i].setbuffer(take(allpasssizeR[i]), allpasssizeR[i]);
+	}
+
+	jassert (next <= delaymemory.get() + totalfloats + alignfloats);
+}
+
+size_t revmodel::getmemorysize()
+{
+	return sizeof(revmodel) + delaymemorysize;
+}
+
+double revmodel::gettaillength(double decaydb)
+{
+	if (mode >= freezemode)
+		return std::numeric_limits<double>::infinity();
+
+	// The longest comb loses 20*log10(roomsize) dB per trip round its
+	// loop, and the loop lengths are fixed in seconds at any sample rate
+	double loopseconds = combtuningR8 / tuningsamplerate;
+	double lossperloop = -20.0 * std::log10((double) roomsize);
+
+	return loopseconds * decaydb / lossperloop;
+}
+
+void revmodel::mute()
+{
+	// Start from the current settings rather than ramping into them
+	if (dirty)
+		update();
+	combs.skipRamp();
+
+	if (getmode() >= freezemode)
+		return;
+
+	combs.mute();
+	for (int i=0;i<numallpasses;i++)
 	{
 		allpassL[i].mute();
 		allpassR[i].mute();
@@ -75,17 +146,18 @@ void revmodel::processreplace(float *inputL, float *inputR, float *outputL, floa
 {
 	float outL,outR,input;
 
+	// The comb bank relies on FTZ/DAZ instead of undenormalise
+	juce::ScopedNoDenormals noDenormals;
+
+	if (dirty)
+		update();
+
 	while(numsamples-- > 0)
 	{
-		outL = outR = 0;
 		input = (*inputL + *inputR) * gain;
 
 		// Accumulate comb filters in parallel
-		for(int i=0; i<numcombs; i++)
-		{
-			outL += combL[i].process(input);
-			outR += combR[i].process(input);
-		}
+		combs.process(input, outL, outR);
 
 		// Feed through allpasses in series
 		for(int i=0; i<numallpasses; i++)
@@ -110,17 +182,18 @@ void revmodel::processmix(float *inputL, float *inputR, float *outputL, float *o
 {
 	float outL,outR,input;
 
+	// The comb bank relies on FTZ/DAZ instead of undenormalise
+	juce::ScopedNoDenormals noDenormals;
+
+	if (dirty)
+		update();
+
 	while(numsamples-- > 0)
 	{
-		outL = outR = 0;
 		input = (*inputL + *inputR) * gain;
 
 		// Accumulate comb filters in parallel
-		for(int i=0; i<numcombs; i++)
-		{
-			outL += combL[i].process(input);
-			outR += combR[i].process(input);
-		}
+		combs.process(input, outL, outR);
 
 		// Feed through allpasses in series
 		for(int i=0; i<numallpasses; i++)
@@ -141,11 +214,94 @@ void revmodel::processmix(float *inputL, float *inputR, float *outputL, float *o
 	}
 }
 
+void revmodel::processblockwet(const float *inputL, const float *inputR, int numsamples)
+{
+	// Fills blockoutL/R with the wet signal for up to maxblocksize samples
+	for(int i=0; i<numsamples; i++)
+		blockinput[i] = (inputL[i] + inputR[i]) * gain;
+
+	// Accumulate comb filters in parallel
+	combs.processBlock(blockinput, blockoutL, blockoutR, numsamples);
+
+	// Feed through allpasses in series
+	for(int i=0; i<numallpasses; i++)
+	{
+		allpassL[i].processblock(blockoutL, numsamples);
+		allpassR[i].processblock(blockoutR, numsamples);
+	}
+}
+
+void revmodel::processblockreplace(const float *inputL, const float *inputR, float *outputL, float *outputR, long numsamples)
+{
+	juce::ScopedNoDenormals noDenormals;
+
+	if (dirty)
+		update();
+
+	while(numsamples > 0)
+	{
+		int chunk = numsamples < maxblocksize ? (int) numsamples : maxblocksize;
+		processblockwet(inputL, inputR, chunk);
+
+		// Calculate output REPLACING anything already there
+		for(int i=0; i<chunk; i++)
+		{
+			float outL = blockoutL[i];
+			float outR = blockoutR[i];
+			float inL = inputL[i];
+			float inR = inputR[i];
+			outputL[i] = outL*wet1 + outR*wet2 + inL*dry;
+			outputR[i] = outR*wet1 + outL*wet2 + inR*dry;
+		}
+
+		inputL += chunk;
+		inputR += chunk;
+		outputL += chunk;
+		outputR += chunk;
+		numsamples -= chunk;
+	}
+}
+
+void revmodel::processblockmix(const float *inputL, const float *inputR, float *outputL, float *outputR, long numsamples, float level)
+{
+	juce::ScopedNoDenormals noDenormals;
+
+	if (dirty)
+		update();
+
+	const float mixwet1 = wet1*level;
+	const float mixwet2 = wet2*level;
+	const float mixdry = dry*level;
+
+	while(numsamples > 0)
+	{
+		int chunk = numsamples < maxblocksize ? (int) numsamples : maxblocksize;
+		processblockwet(inputL, inputR, chunk);
+
+		// Calculate output MIXING with anything already there
+		for(int i=0; i<chunk; i++)
+		{
+			float outL = blockoutL[i];
+			float outR = blockoutR[i];
+			float inL = inputL[i];
+			float inR = inputR[i];
+			outputL[i] += outL*mixwet1 + outR*mixwet2 + inL*mixdry;
+			outputR[i] += outR*mixwet1 + outL*mixwet2 + inR*mixdry;
+		}
+
+		inputL += chunk;
+		inputR += chunk;
+		outputL += chunk;
+		outputR += chunk;
+		numsamples -= chunk;
+	}
+}
+
 void revmodel::update()
 {
 // Recalculate internal values after parameter change
 
-	int i;
+	dirty = false;
 
 	wet1 = wet*(width/2 + 0.5f);
 	wet2 = wet*((1-width)/2);
@@ -163,28 +319,27 @@ void revmodel::update()
 		gain = fixedgain;
 	}
 
-	for(i=0; i<numcombs; i++)
-	{
-		combL[i].setfeedback(roomsize1);
-		combR[i].setfeedback(roomsize1);
-	}
-
-	for(i=0; i<numcombs; i++)
-	{
-		combL[i].setdamp(damp1);
-		combR[i].setdamp(damp1);
-	}
+	combs.setFeedback(roomsize1);
+	combs.setDamp(damp1);
 }
 
 // The following get/set functions are not inlined, because
 // speed is never an issue when calling them, and also
 // because as you develop the reverb model, you may
 // wish to take dynamic action when they are called.
+//
+// Setters only stage the new value: update() runs once,
+// at the start of the next process call, and only if
+// something actually changed.
 
 void revmodel::setroomsize(float value)
 {
-	roomsize = (value*scaleroom) + offsetroom;
-	update();
+	float newvalue = (value*scaleroom) + offsetroom;
+	if (newvalue == roomsize)
+		return;
+
+	roomsize = newvalue;
+	dirty = true;
 }
 
 float revmodel::getroomsize()
@@ -194,8 +349,12 @@ float revmodel::getroomsize()
 
 void revmodel::setdamp(float value)
 {
-	damp = value*scaledamp;
-	update();
+	float newvalue = value*scaledamp;
+	if (newvalue == damp)
+		return;
+
+	damp = newvalue;
+	dirty = true;
 }
 
 float revmodel::getdamp()
@@ -205,8 +364,12 @@ float revmodel::getdamp()
 
 void revmodel::setwet(float value)
 {
-	wet = value*scalewet;
-	update();
+	float newvalue = value*scalewet;
+	if (newvalue == wet)
+		return;
+
+	wet = newvalue;
+	dirty = true;
 }
 
 float revmodel::getwet()
@@ -226,8 +389,12 @@ float revmodel::getdry()
 
 void revmodel::setwidth(float value)
 {
-	width = value;
-	update();
+	float newvalue = value;
+	if (newvalue == width)
+		return;
+
+	width = newvalue;
+	dirty = true;
 }
 
 float revmodel::getwidth()
@@ -237,8 +404,12 @@ float revmodel::getwidth()
 
 void revmodel::setmode(float value)
 {
-	mode = value;
-	update();
+	float newvalue = value;
+	if (newvalue == mode)
+		return;
+
+	mode = newvalue;
+	dirty = true;
 }
 
 float revmodel::getmode()
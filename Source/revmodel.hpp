@@ -7,7 +7,7 @@
 #ifndef _revmodel_
 #define _revmodel_
 
-#include "comb.hpp"
+#include "CombBank.h"
 #include "allpass.hpp"
 #include "tuning.h"
 
@@ -15,9 +15,21 @@ class revmodel
 {
 public:
 					revmodel();
+			// Scales every delay line to the sample rate and (re)allocates
+			// them all as one block. Not real-time safe - call from prepare.
+			void	setsamplerate(double samplerate);
+			size_t	getmemorysize();
+			// Seconds for the tail to fall by decaydb (a positive dB figure),
+			// from the slowest comb's feedback. Damping only shortens this.
+			double	gettaillength(double decaydb);
 			void	mute();
 			void	processmix(float *inputL, float *inputR, float *outputL, float *outputR, long numsamples, int skip);
 			void	processreplace(float *inputL, float *inputR, float *outputL, float *outputR, long numsamples, int skip);
+			// Block versions of the above: every comb bank register and then
+			// every allpass runs over a whole block at a time (non-interleaved only).
+			// processblockmix scales what it adds by level, so it can be used as a send.
+			void	processblockreplace(const float *inputL, const float *inputR, float *outputL, float *outputR, long numsamples);
+			void	processblockmix(const float *inputL, const float *inputR, float *outputL, float *outputR, long numsamples, float level = 1.0f);
 			void	setroomsize(float value);
 			float	getroomsize();
 			void	setdamp(float value);
@@ -32,6 +44,7 @@ public:
 			float	getmode();
 private:
 			void	update();
+			void	processblockwet(const float *inputL, const float *inputR, int numsamples);
 private:
 	float	gain;
 	float	roomsize,roomsize1;
@@ -40,46 +53,27 @@ private:
 	float	dry;
 	float	width;
 	float	mode;
+	bool	dirty;
 
-	// The following are all declared inline 
-	// to remove the need for dynamic allocation
-	// with its subsequent error-checking messiness
-
-	// Comb filters
-	comb	combL[numcombs];
-	comb	combR[numcombs];
+	// Comb filters - all 2 x numcombs run together in SIMD lanes
+	CombBank	combs;
 
 	// Allpass filters
 	allpass	allpassL[numallpasses];
 	allpass	allpassR[numallpasses];
 
-	// Buffers for the combs
-	float	bufcombL1[combtuningL1];
-	float	bufcombR1[combtuningR1];
-	float	bufcombL2[combtuningL2];
-	float	bufcombR2[combtuningR2];
-	float	bufcombL3[combtuningL3];
-	float	bufcombR3[combtuningR3];
-	float	bufcombL4[combtuningL4];
-	float	bufcombR4[combtuningR4];
-	float	bufcombL5[combtuningL5];
-	float	bufcombR5[combtuningR5];
-	float	bufcombL6[combtuningL6];
-	float	bufcombR6[combtuningR6];
-	float	bufcombL7[combtuningL7];
-	float	bufcombR7[combtuningR7];
-	float	bufcombL8[combtuningL8];
-	float	bufcombR8[combtuningR8];
+	// Working buffers for the block path, which
+	// runs in chunks of at most maxblocksize
+	static const int maxblocksize = 256;
+	float	blockinput[maxblocksize];
+	float	blockoutL[maxblocksize];
+	float	blockoutR[maxblocksize];
 
-	// Buffers for the allpasses
-	float	bufallpassL1[allpasstuningL1];
-	float	bufallpassR1[allpasstuningR1];
-	float	bufallpassL2[allpasstuningL2];
-	float	bufallpassR2[allpasstuningR2];
-	float	bufallpassL3[allpasstuningL3];
-	float	bufallpassR3[allpasstuningR3];
-	float	bufallpassL4[allpasstuningL4];
-	float	bufallpassR4[allpasstuningR4];
+	// Every comb and allpass delay line lives in this one
+	// allocation, each starting on its own cache line
+	juce::HeapBlock<float>	delaymemory;
+	size_t	delaymemorysize;
+	double	samplerate;
 };
 
 #endif//_revmodel_
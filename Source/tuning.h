@@ -29,6 +29,9 @@ const int	stereospread	= 23;
 // they will probably be OK for 48KHz sample rate
 // but would need scaling for 96KHz (or other) sample rates.
 // The values were obtained by listening tests.
+// revmodel::setsamplerate scales them to the running rate.
+const double tuningsamplerate	= 44100;
+const int	cachelinebytes	= 64;
 const int combtuningL1		= 1116;
 const int combtuningR1		= 1116+stereospread;
 const int combtuningL2		= 1188;